@@ -0,0 +1,160 @@
+// Benchmark de churn: cria e demole buildings sem parar, mantendo uma
+// populacao fixa, e mede a vazao e o pico de memoria (RSS). Um operator new
+// global conta toda alocacao do caminho Manager::criabuilding /
+// demolirbuilding (pools, registro, colunas, indice espacial, nomes...),
+// nao so os blocos dos pools.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target churnbench
+// Uso: ./churnbench [populacao] [ciclos]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <algorithm>
+#include <sys/resource.h>
+#include "manager.hpp"
+
+using namespace std;
+
+static std::atomic<uint64_t> g_allocs(0);
+static std::atomic<uint64_t> g_bytes(0);
+
+// Todas as formas de new/delete, como no econbench.cpp.
+static void* counted(size_t size) noexcept
+{
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size == 0 ? 1 : size);
+}
+
+static void* countedAligned(size_t size, std::align_val_t align) noexcept
+{
+    size_t a = std::max((size_t)align, sizeof(void*));
+    char* raw = (char*)counted(size + a + sizeof(void*));
+    if (raw == nullptr) return nullptr;
+    uintptr_t start = ((uintptr_t)(raw + sizeof(void*)) + a - 1) & ~(uintptr_t)(a - 1);
+    ((void**)start)[-1] = raw;
+    return (void*)start;
+}
+
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void release(void* p) noexcept
+{
+    free(p);
+}
+
+static void releaseAligned(void* p) noexcept
+{
+    if (p != nullptr) release(((void**)p)[-1]);
+}
+
+void* operator new(size_t size)
+{
+    void* p = counted(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    void* p = counted(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+    void* p = countedAligned(size, align);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+    void* p = countedAligned(size, align);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted(size); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAligned(size, align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAligned(size, align); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+
+static long peakRssKb(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t population = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+    size_t cycles = argc > 2 ? strtoull(argv[2], nullptr, 10) : 5000000;
+    cout.setstate(ios::failbit); // silencia as mensagens do Manager
+
+    Manager runner;
+    runner.selectCompany((int)runner.criarCompany("churn"));
+    uint64_t state = 88172645463325252ull; // xorshift, sem depender de <random>
+    auto rnd = [&](){ state ^= state << 13; state ^= state >> 7; state ^= state << 17; return state; };
+    uint64_t a0 = g_allocs, b0 = g_bytes;
+    for (size_t i = 0; i < population; i++){
+        runner.criabuilding(1 + (int)(i % 3), "predio", (int)(rnd() % 4096), (int)(rnd() % 4096));
+    }
+    uint64_t fillallocs = g_allocs - a0, fillbytes = g_bytes - b0;
+    long rssfilled = peakRssKb();
+
+    a0 = g_allocs;
+    b0 = g_bytes;
+    auto start = chrono::steady_clock::now();
+    for (size_t c = 0; c < cycles; c++){
+        runner.demolirbuilding((size_t)(rnd() % population));
+        runner.criabuilding(1 + (int)(c % 3), "predio", (int)(rnd() % 4096), (int)(rnd() % 4096));
+    }
+    auto end = chrono::steady_clock::now();
+    uint64_t churnallocs = g_allocs - a0, churnbytes = g_bytes - b0;
+    long rssend = peakRssKb();
+
+    // Handles de antes do reset nao podem achar os buildings novos que
+    // caem nos mesmos slots.
+    std::vector<Handle> before;
+    for (size_t i = 0; i < 1000; i++) before.push_back(runner.criabuilding(1, "antes", 0, 0));
+    runner.reset();
+    runner.selectCompany((int)runner.criarCompany("depois"));
+    for (size_t i = 0; i < population + 1000; i++) runner.criabuilding(1, "depois", 0, 0);
+    bool stale = true;
+    for (Handle h : before) stale = stale && runner.getbuilding(h) == nullptr;
+
+    double sec = chrono::duration<double>(end - start).count();
+    cout.clear();
+    cout << "population=" << population << " cycles=" << cycles << "\n";
+    cout << "cycles_per_sec=" << cycles / sec
+         << " ns_per_cycle=" << sec * 1e9 / cycles << "\n";
+    cout << "fill_allocs_per_create=" << (double)fillallocs / population
+         << " fill_bytes_per_create=" << (double)fillbytes / population << "\n";
+    cout << "churn_allocs_per_cycle=" << (double)churnallocs / cycles
+         << " churn_bytes_per_cycle=" << (double)churnbytes / cycles
+         << " churn_allocs=" << churnallocs << "\n";
+    cout << "peak_rss_kb_after_fill=" << rssfilled
+         << " peak_rss_kb_after_churn=" << rssend << "\n";
+    cout << "stale_handles_after_reset=" << (stale ? "rejected" : "RESOLVED") << "\n";
+    return 0;
+}
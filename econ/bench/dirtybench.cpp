@@ -0,0 +1,106 @@
+// Benchmark do turno incremental: dois TurnEngine com o mesmo mundo, um
+// rodando o laco cheio e outro so os buildings na fila. A cada turno uma
+// fracao dos buildings muda (preco ou producao, sorteados pelo rng.hpp)
+// nos dois; mede o turno (mudancas incluidas) e confere que o caixa de
+// cada company e as colunas no fim sao identicos.
+// Dois padroes: "clustered" muda trechos de 64 slots seguidos (os
+// buildings de uma company sao criados juntos), "random" espalha cada
+// mudanca num slot qualquer, o pior caso para o cache.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target dirtybench
+// Uso: ./dirtybench [buildings] [companies] [turnos] [threads]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "turnengine.hpp"
+#include "threadpool.hpp"
+#include "rng.hpp"
+
+using namespace std;
+
+static void fill(TurnEngine& engine, size_t nbuildings, size_t ncompanies)
+{
+    for (size_t i = 0; i < nbuildings; i++){
+        RandomStream r(1, 0, i, RngWorldGen);
+        engine.addBuilding(r.range(1, 3), r.range(0, (int32_t)ncompanies - 1));
+    }
+}
+
+// Metade muda o preco; a outra metade a producao, que abaixo da demanda
+// faz o building vender o estoque por alguns turnos antes de estabilizar.
+static void change(TurnEngine& engine, uint64_t turn, size_t k, bool clustered)
+{
+    RandomStream r(2, turn, 0, RngProduction);
+    const size_t run = clustered ? 64 : 1;
+    for (size_t j = 0; j < k; j += run){
+        size_t first = (size_t)r.range(0, (int32_t)(engine.size() - run));
+        for (size_t slot = first; slot < first + run && j + slot - first < k; slot++){
+            if (slot % 2 == 0) engine.set(FieldPrice, slot, r.range(1, 5));
+            else engine.set(FieldProduction, slot, r.range(0, 12));
+        }
+    }
+}
+
+static bool samecolumn(const Column& a, const Column& b)
+{
+    for (size_t i = 0; i < a.size(); i++){
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t nbuildings = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t ncompanies = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000;
+    int nturns = argc > 3 ? atoi(argv[3]) : 20;
+    size_t threads = argc > 4 ? strtoull(argv[4], nullptr, 10) : 0;
+    const double fractions[] = {0.0, 0.001, 0.01, 0.05, 0.2};
+
+    ThreadPool pool(threads);
+    cout << "buildings=" << nbuildings << " companies=" << ncompanies
+         << " turns=" << nturns << " threads=" << pool.size() << "\n";
+
+    for (int pattern = 0; pattern < 2; pattern++)
+    for (double f : fractions){
+        bool clustered = pattern == 0;
+        TurnEngine full, incremental;
+        full.setIncremental(false);
+        fill(full, nbuildings, ncompanies);
+        fill(incremental, nbuildings, ncompanies);
+        full.run(ncompanies, &pool); // aquecimento: o incremental classifica tudo aqui
+        incremental.run(ncompanies, &pool);
+
+        size_t k = (size_t)(f * nbuildings);
+        double fullms = 0, incms = 0;
+        uint64_t touched = 0, companies = 0;
+        bool match = true;
+        for (int t = 0; t < nturns; t++){
+            auto a = chrono::steady_clock::now();
+            change(full, full.turn(), k, clustered);
+            full.run(ncompanies, &pool);
+            auto b = chrono::steady_clock::now();
+            change(incremental, incremental.turn(), k, clustered);
+            incremental.run(ncompanies, &pool);
+            auto c = chrono::steady_clock::now();
+            fullms += chrono::duration<double, milli>(b - a).count();
+            incms += chrono::duration<double, milli>(c - b).count();
+            touched += incremental.touched();
+            companies += incremental.companiestouched();
+            for (size_t co = 0; co < ncompanies; co++) match = match && full.cashdelta(co) == incremental.cashdelta(co);
+        }
+
+        incremental.sync();
+        const BuildingColumns& x = full.columns();
+        const BuildingColumns& y = incremental.columns();
+        bool columns = samecolumn(x.stock, y.stock) && samecolumn(x.income, y.income)
+                    && samecolumn(x.production, y.production) && samecolumn(x.price, y.price);
+
+        cout << "pattern=" << (clustered ? "clustered" : "random") << " changed_pct=" << f * 100 << " full_ms=" << fullms / nturns
+             << " incremental_ms=" << incms / nturns << " speedup=" << fullms / incms
+             << " buildings_touched=" << touched / nturns << " companies_touched=" << companies / nturns
+             << " cash_match=" << (match ? "yes" : "NO") << " columns_match=" << (columns ? "yes" : "NO") << "\n";
+    }
+    return 0;
+}
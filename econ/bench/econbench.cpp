@@ -0,0 +1,193 @@
+// Suite de benchmarks do nucleo econ: criacao de companies e buildings,
+// listagens, caixa e turnos completos, em mundos de 1k ate 10M buildings.
+// Uma linha por medida, formato chave=valor, para comparar versoes:
+//   bench=<caso> size=<buildings> ops=<n> ns_per_op=<x> allocs_per_op=<y> bytes_per_op=<z>
+// ns_per_op e a mediana de "repeticoes" rodadas.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target econbench
+//   (ou a tarefa "build econbench" em econ/.vscode/tasks.json)
+// Uso: ./econbench [maior mundo] [repeticoes]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "manager.hpp"
+#include "profiler.hpp"
+
+using namespace std;
+
+static uint64_t g_allocs = 0;
+static uint64_t g_bytes = 0;
+
+// Todas as formas de new/delete passam por aqui, senao um delete da
+// biblioteca liberaria com o operador errado (-Wmismatched-new-delete).
+// As alinhadas guardam o ponteiro do malloc logo antes do bloco.
+static void* counted(size_t size) noexcept
+{
+    g_allocs++;
+    g_bytes += size;
+    return malloc(size == 0 ? 1 : size);
+}
+
+static void* countedAligned(size_t size, std::align_val_t align) noexcept
+{
+    size_t a = std::max((size_t)align, sizeof(void*));
+    char* raw = (char*)counted(size + a + sizeof(void*));
+    if (raw == nullptr) return nullptr;
+    uintptr_t start = ((uintptr_t)(raw + sizeof(void*)) + a - 1) & ~(uintptr_t)(a - 1);
+    ((void**)start)[-1] = raw;
+    return (void*)start;
+}
+
+// Fora de linha: com o free() visivel dentro do delete o GCC acusa
+// new/free trocados mesmo sendo o par certo.
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void release(void* p) noexcept
+{
+    free(p);
+}
+
+static void releaseAligned(void* p) noexcept
+{
+    if (p != nullptr) release(((void**)p)[-1]);
+}
+
+void* operator new(size_t size)
+{
+    void* p = counted(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    void* p = counted(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+    void* p = countedAligned(size, align);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+    void* p = countedAligned(size, align);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted(size); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAligned(size, align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAligned(size, align); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+
+namespace {
+    // Descarta a saida das listagens sem formatar para terminal.
+    class NullBuffer : public std::streambuf {
+        protected:
+            int overflow(int c) override { return c; }
+            std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    struct Sample {
+        double ns;
+        uint64_t allocs;
+        uint64_t bytes;
+    };
+
+    // Roda "fn" (que faz "ops" operacoes) "reps" vezes; "setup" prepara
+    // cada rodada fora da medida.
+    void measure(const char* name, size_t size, size_t ops, int reps,
+                 const std::function<void()>& setup, const std::function<void()>& fn)
+    {
+        std::vector<Sample> samples;
+        for (int r = 0; r < reps; r++){
+            setup();
+            uint64_t a0 = g_allocs, b0 = g_bytes;
+            auto start = chrono::steady_clock::now();
+            fn();
+            auto end = chrono::steady_clock::now();
+            samples.push_back(Sample{chrono::duration<double, nano>(end - start).count(), g_allocs - a0, g_bytes - b0});
+        }
+        std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b){ return a.ns < b.ns; });
+        const Sample& m = samples[samples.size() / 2];
+        fprintf(stdout, "bench=%s size=%zu ops=%zu ns_per_op=%.2f allocs_per_op=%.4f bytes_per_op=%.2f\n",
+                name, size, ops, m.ns / ops, (double)m.allocs / ops, (double)m.bytes / ops);
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxsize = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+    if (reps < 1) reps = 1;
+
+    NullBuffer nullbuf;
+    std::streambuf* console = cout.rdbuf(&nullbuf); // mensagens do Manager
+
+    for (size_t size = 1000; size <= maxsize; size *= 10){
+        const size_t ncompanies = size / 100 > 0 ? size / 100 : 1;
+        Manager* world = nullptr;
+
+        // Companies: criarCompany, com o pool e o livro-caixa do Manager.
+        measure("company_create", size, ncompanies, reps,
+            [&]{ delete world; world = new Manager(); },
+            [&]{ for (size_t c = 0; c < ncompanies; c++) world->criarCompany("company"); });
+
+        // Buildings: Manager::criabuilding -> Company::criabuilding, 100 por company.
+        measure("building_create", size, size, reps,
+            [&]{
+                delete world; world = new Manager();
+                for (size_t c = 0; c < ncompanies; c++) world->criarCompany("company");
+            },
+            [&]{
+                for (size_t i = 0; i < size; i++){
+                    if (i % 100 == 0) world->selectCompany((int)(i / 100 % ncompanies));
+                    world->criabuilding(1 + (int)(i % 3), "predio", (int)(i % 1000), (int)(i / 1000));
+                }
+            });
+
+        // O mundo do ultimo building_create serve para os casos seguintes.
+        auto none = []{};
+        measure("company_list", size, ncompanies, reps, none, [&]{ world->listCompanies(); });
+        measure("building_list", size, 100, reps,
+            [&]{ world->selectCompany(0); }, [&]{ world->listBuildings(); });
+        measure("cash_update", size, size, reps, none, [&]{
+            for (size_t i = 0; i < size; i++) world->getcompany((int)(i % ncompanies))->addcash(Money::units(1));
+        });
+        measure("turn", size, size, reps, none, [&]{ world->passarturno(); });
+        // Mesmo turno com os cronometros ligados: a diferenca e o custo do profiler.
+        Profiler::enabled = true;
+        measure("turn_profiled", size, size, reps, none, [&]{ world->passarturno(); });
+        Profiler::enabled = false;
+        Profiler::clear();
+        delete world;
+    }
+
+    cout.rdbuf(console);
+    return 0;
+}
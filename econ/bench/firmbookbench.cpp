@@ -0,0 +1,88 @@
+// Benchmark do FirmBook: custo de addcash com e sem livro-caixa, vazao de
+// lancamentos gravados em grupo e tempo de replay do diario.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target firmbookbench
+// Uso: ./firmbookbench [lancamentos] [companies] [arquivo]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include "company.hpp"
+#include "firmbook.hpp"
+
+using namespace std;
+
+static double run(std::vector<Company*>& companies, size_t npostings)
+{
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < npostings; i++){
+        Company* c = companies[i % companies.size()];
+        if (i & 1) c->addcash(Money::fromCents((int64_t)(i & 1023)));
+        else c->subcash(Money::fromCents((int64_t)(i & 511)));
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t npostings = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t ncompanies = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000;
+    std::string path = argc > 3 ? argv[3] : "firmbookbench.journal";
+    remove(path.c_str());
+
+    std::vector<Company*> plain, booked;
+    FirmBook book;
+    book.open(path);
+    CashBook cash;
+    cash.attachjournal(&book);
+    for (size_t c = 0; c < ncompanies; c++){
+        plain.push_back(new Company("plain", Money::units(1000)));
+        booked.push_back(new Company("booked", Money::units(1000)));
+        booked.back()->attachbook(&cash);
+    }
+
+    double plainsec = run(plain, npostings);
+    double bookedsec = run(booked, npostings);
+    book.flush();
+
+    auto start = chrono::steady_clock::now();
+    std::vector<int64_t> balances;
+    bool replayed = FirmBook::replay(path, balances);
+    auto end = chrono::steady_clock::now();
+
+    bool match = replayed && balances.size() == ncompanies;
+    for (size_t c = 0; match && c < ncompanies; c++){
+        match = balances[c] == booked[c]->getcash().cents;
+    }
+
+    cout << "postings=" << npostings << " companies=" << ncompanies
+         << " groups=" << book.groups() << "\n";
+    cout << "addcash_plain_ns=" << plainsec * 1e9 / npostings
+         << " addcash_booked_ns=" << bookedsec * 1e9 / npostings
+         << " postings_per_sec=" << npostings / bookedsec << "\n";
+    cout << "replay_ms=" << chrono::duration<double, milli>(end - start).count()
+         << " balances_match=" << (match ? "yes" : "NO") << "\n";
+    book.close();
+
+    // Segunda sessao no mesmo diario, depois de uma gravacao interrompida:
+    // o replay tem que dar so os saldos do mundo novo (uma company).
+    FILE* torn = fopen(path.c_str(), "ab");
+    fwrite("partial", 7, 1, torn);
+    fclose(torn);
+    FirmBook again;
+    bool reopened = again.open(path);
+    CashBook cash2;
+    cash2.attachjournal(&again);
+    Company fresh("fresh", Money::units(50));
+    fresh.attachbook(&cash2);
+    fresh.addcash(Money::units(7));
+    again.flush();
+    bool rematch = reopened && FirmBook::replay(path, balances)
+                && balances.size() == 1 && balances[0] == fresh.getcash().cents;
+    cout << "reopen_match=" << (rematch ? "yes" : "NO") << "\n";
+    again.close();
+    remove(path.c_str());
+    return 0;
+}
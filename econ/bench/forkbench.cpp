@@ -0,0 +1,102 @@
+// Benchmark dos forks do mundo: mede Manager::fork() num mundo grande
+// contra uma copia funda das colunas, roda varios forks em paralelo (cada
+// um com 10 fabricas a mais numa company) e confere que:
+//   - o fork sem mudancas chega ao mesmo caixa que o mundo original,
+//     mesmo com o original rodando antes dos forks;
+//   - cada fork so mudou o caixa da sua company, pelo valor esperado;
+//   - cada fork copiou so os pedacos que escreveu.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target forkbench
+// Uso: ./forkbench [buildings] [companies] [forks] [turnos]
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "manager.hpp"
+#include "fork.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t nbuildings = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t ncompanies = argc > 2 ? strtoull(argv[2], nullptr, 10) : 100;
+    size_t nforks = argc > 3 ? strtoull(argv[3], nullptr, 10) : 8;
+    int nturns = argc > 4 ? atoi(argv[4]) : 10;
+    if (nforks > ncompanies) nforks = ncompanies;
+    cout.setstate(ios::failbit); // silencia as mensagens do Manager
+
+    Manager world;
+    for (size_t c = 0; c < ncompanies; c++) world.criarCompany("company" + std::to_string(c));
+    for (size_t i = 0; i < nbuildings; i++){
+        if (i % (nbuildings / ncompanies + 1) == 0) world.selectCompany((int)(i * ncompanies / nbuildings));
+        world.criabuilding(1 + (int)(i % 3), "predio");
+    }
+    world.passarturno();
+
+    // Mediana de muitos forks, jogados fora logo em seguida.
+    std::vector<double> forkus;
+    for (int r = 0; r < 101; r++){
+        auto a = chrono::steady_clock::now();
+        WorldFork f = world.fork();
+        auto b = chrono::steady_clock::now();
+        forkus.push_back(chrono::duration<double, micro>(b - a).count());
+    }
+    std::sort(forkus.begin(), forkus.end());
+
+    // O que um fork custaria copiando tudo.
+    auto d0 = chrono::steady_clock::now();
+    const BuildingColumns& cols = world.engine().columns();
+    std::vector<int32_t> deep[7];
+    const Column* all[7] = {&cols.production, &cols.demand, &cols.stock, &cols.price, &cols.cost, &cols.owner, &cols.income};
+    for (int k = 0; k < 7; k++){
+        deep[k].resize(all[k]->size());
+        all[k]->copyout(0, all[k]->size(), deep[k].data());
+    }
+    auto d1 = chrono::steady_clock::now();
+
+    // Fork 0 sem mudancas; fork k > 0: company k paga e ganha 10 fabricas
+    // (tipo 3: vende 8 a 3, custa 10, +14 por turno cada).
+    std::vector<WorldFork> forks;
+    for (size_t k = 0; k < nforks; k++){
+        forks.push_back(world.fork());
+        if (k == 0) continue;
+        forks[k].pay((uint32_t)k, Money::units(1000));
+        for (int f = 0; f < 10; f++) forks[k].addBuilding(3, (uint32_t)k);
+    }
+
+    // O mundo original anda primeiro: seus turnos nao podem vazar nos forks.
+    for (int t = 0; t < nturns; t++) world.passarturno();
+
+    ThreadPool pool;
+    auto r0 = chrono::steady_clock::now();
+    WorldFork::runall(forks, nturns, pool);
+    auto r1 = chrono::steady_clock::now();
+
+    bool baseline = true;
+    for (size_t c = 0; c < ncompanies; c++){
+        baseline = baseline && forks[0].cash((uint32_t)c) == world.cashbook().balance((uint32_t)c);
+    }
+    bool isolated = true;
+    for (size_t k = 1; k < nforks; k++){
+        for (size_t c = 0; c < ncompanies; c++){
+            Money expect = forks[0].cash((uint32_t)c);
+            if (c == k) expect = expect - Money::units(1000) + Money::units(10 * 14 * nturns);
+            isolated = isolated && forks[k].cash((uint32_t)c) == expect;
+        }
+    }
+    uint64_t copied = 0;
+    for (const WorldFork& f : forks) copied += f.copiedchunks();
+    size_t chunks = 7 * cols.stock.nchunks() + world.cashbook().balances().nchunks();
+
+    cout.clear();
+    cout << "buildings=" << nbuildings << " companies=" << ncompanies << " forks=" << nforks
+         << " turns=" << nturns << " threads=" << pool.size() << "\n";
+    cout << "fork_us=" << forkus[forkus.size() / 2]
+         << " deep_copy_us=" << chrono::duration<double, micro>(d1 - d0).count()
+         << " forks_run_ms=" << chrono::duration<double, milli>(r1 - r0).count() << "\n";
+    cout << "baseline_match=" << (baseline ? "yes" : "NO") << " forks_isolated=" << (isolated ? "yes" : "NO")
+         << " copied_chunks_per_fork=" << (double)copied / nforks << " of " << chunks << "\n";
+    return 0;
+}
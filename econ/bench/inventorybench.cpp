@@ -0,0 +1,105 @@
+// Benchmark do Inventory: um turno de envelhecimento e armazenagem sobre
+// milhoes de entradas, kernel escalar contra AVX2 (se a CPU tiver), e o
+// custo de demolir buildings com o estoque cheio.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target inventorybench
+// Uso: ./inventorybench [entradas] [produtos] [companies]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "inventory.hpp"
+
+using namespace std;
+
+static void fill(Inventory& inv, size_t n, size_t nproducts, size_t ncompanies)
+{
+    for (size_t p = 0; p < nproducts; p++){
+        Inventory::ProductRules rules;
+        rules.decay = 0.98f + 0.001f * (float)(p % 10);
+        inv.setRules((uint32_t)p, rules);
+    }
+    for (size_t i = 0; i < n; i++){
+        inv.add((uint32_t)(i % nproducts), (uint32_t)(i % ncompanies), NullHandle, 10.0f + (float)(i % 1000), 1.0f);
+    }
+}
+
+static double time(Inventory& inv, size_t ncompanies, int turns)
+{
+    double best = 1e30;
+    for (int t = 0; t < turns; t++){
+        auto start = chrono::steady_clock::now();
+        inv.age(ncompanies);
+        auto end = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(end - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 4000000;
+    size_t nproducts = argc > 2 ? strtoull(argv[2], nullptr, 10) : 16;
+    size_t ncompanies = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1000;
+    const int turns = 20;
+
+    Inventory scalar;
+    scalar.setKernel(Inventory::scalarKernel());
+    fill(scalar, n, nproducts, ncompanies);
+    double scalarms = time(scalar, ncompanies, turns);
+
+    cout << "entries=" << n << " products=" << nproducts << " cpu_kernel=" << Inventory::kernelName() << "\n";
+    cout << "scalar_ms=" << scalarms << " ns_per_entry=" << scalarms * 1e6 / n << "\n";
+
+    if (Inventory::avx2Kernel() != nullptr){
+        Inventory avx2;
+        avx2.setKernel(Inventory::avx2Kernel());
+        fill(avx2, n, nproducts, ncompanies);
+        double avx2ms = time(avx2, ncompanies, turns);
+
+        bool same = true;
+        for (uint32_t p = 0; same && p < nproducts; p++){
+            const Inventory::Columns& a = scalar.columns(p);
+            const Inventory::Columns& b = avx2.columns(p);
+            size_t bytes = a.quantity.size() * sizeof(float);
+            same = memcmp(a.quantity.data(), b.quantity.data(), bytes) == 0
+                && memcmp(a.quality.data(), b.quality.data(), bytes) == 0
+                && memcmp(a.age.data(), b.age.data(), bytes) == 0
+                && memcmp(a.charge.data(), b.charge.data(), bytes) == 0;
+        }
+        for (size_t c = 0; same && c < ncompanies; c++) same = scalar.chargeOf(c) == avx2.chargeOf(c);
+        cout << "avx2_ms=" << avx2ms << " ns_per_entry=" << avx2ms * 1e6 / n
+             << " speedup=" << scalarms / avx2ms
+             << " bit_identical=" << (same ? "yes" : "NO") << "\n";
+    }
+
+    // Demolicao: metade dos buildings sai; o custo deve seguir as entradas
+    // do building, nao o estoque inteiro.
+    const size_t nbuildings = n / 8 + 1;
+    Inventory demo;
+    for (size_t i = 0; i < n; i++){
+        demo.add((uint32_t)(i % nproducts), (uint32_t)(i % ncompanies), (Handle)(i % nbuildings + 1), (float)i, 1.0f);
+    }
+    double expected = 0;
+    for (size_t i = 0; i < n; i++) if ((i % nbuildings) % 2 == 1) expected += (double)i;
+    size_t removed = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t b = 0; b < nbuildings; b += 2) removed += demo.removeBuilding((Handle)(b + 1));
+    auto end = chrono::steady_clock::now();
+    double demoms = chrono::duration<double, milli>(end - start).count();
+    double left = 0;
+    bool clean = true;
+    for (uint32_t p = 0; p < nproducts; p++){
+        const Inventory::Columns& c = demo.columns(p);
+        for (size_t i = 0; i < c.quantity.size(); i++){
+            left += c.quantity[i];
+            clean = clean && (c.building[i] - 1) % 2 == 1;
+        }
+    }
+    clean = clean && left == expected && demo.removeBuilding(1) == 0;
+    size_t demolished = (nbuildings + 1) / 2;
+    cout << "demolish_ms=" << demoms << " ns_per_building=" << demoms * 1e6 / demolished
+         << " entries_removed=" << removed << " demolish_ok=" << (clean ? "yes" : "NO") << "\n";
+    return 0;
+}
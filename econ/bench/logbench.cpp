@@ -0,0 +1,51 @@
+// Benchmark de criacao em massa: o log antigo dos construtores (duas linhas
+// com endl por objeto) contra o ELOG_DEBUG atual, que some na compilacao.
+// O "antes" grava num arquivo; num terminal ele e ainda mais lento.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target logbench
+// Uso: ./logbench [buildings] [arquivo]
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include "buildings.hpp"
+#include "pool.hpp"
+#include "log.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    std::string path = argc > 2 ? argv[2] : "logbench.out";
+
+    // Antes: o que os construtores faziam, com o mesmo custo de criar.
+    std::ofstream out(path);
+    ObjectPool<Building> before;
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++){
+        Building* b = before.create(1, "farm");
+        out << "building (" << b << ") constructed!" << endl;
+        out << "UID = "<< b->uniqueID() << endl;
+    }
+    auto t1 = chrono::steady_clock::now();
+    out.close();
+    remove(path.c_str());
+
+    // Depois: construtor com ELOG_DEBUG (desligado em ECON_LOG_LEVEL padrao).
+    ObjectPool<Building> after;
+    auto t2 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++){
+        after.create(1, "farm");
+    }
+    auto t3 = chrono::steady_clock::now();
+
+    double beforens = chrono::duration<double, nano>(t1 - t0).count() / n;
+    double afterns = chrono::duration<double, nano>(t3 - t2).count() / n;
+    cout << "buildings=" << n << " log_level=" << ECON_LOG_LEVEL << "\n";
+    cout << "before_ns_per_building=" << beforens
+         << " after_ns_per_building=" << afterns
+         << " speedup=" << beforens / afterns << "\n";
+    return 0;
+}
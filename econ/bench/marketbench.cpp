@@ -0,0 +1,55 @@
+// Benchmark do Market: leilao por turno com muitas ordens por produto.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target marketbench
+// Uso: ./marketbench [ordens por produto] [produtos] [companies] [threads]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "market.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t norders = argc > 1 ? strtoull(argv[1], nullptr, 10) : 500000;
+    size_t nproducts = argc > 2 ? strtoull(argv[2], nullptr, 10) : 4;
+    size_t ncompanies = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1000;
+    size_t nthreads = argc > 4 ? strtoull(argv[4], nullptr, 10) : 0;
+
+    uint64_t state = 88172645463325252ull;
+    auto rnd = [&](){ state ^= state << 13; state ^= state >> 7; state ^= state << 17; return state; };
+
+    Market market;
+    ThreadPool pool(nthreads);
+    double best = 1e30;
+    OrderBook::Result r{-1, 0};
+    for (int round = 0; round < 5; round++){
+        for (size_t p = 0; p < nproducts; p++){
+            OrderBook& book = market.book((uint32_t)p);
+            for (size_t i = 0; i < norders; i++){
+                uint32_t company = (uint32_t)(rnd() % ncompanies);
+                int32_t qty = 1 + (int32_t)(rnd() % 100);
+                // Compras em torno de 520, vendas em torno de 500.
+                if (i & 1) book.bid(company, 420 + (int32_t)(rnd() % 200), qty);
+                else book.ask(company, 400 + (int32_t)(rnd() % 200), qty);
+            }
+        }
+        auto start = chrono::steady_clock::now();
+        market.clear(ncompanies, &pool);
+        auto end = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(end - start).count();
+        if (ms < best) best = ms;
+        r = market.book(0).last();
+
+        int64_t net = 0; // dinheiro nao e criado nem destruido
+        for (size_t c = 0; c < ncompanies; c++) net += market.cashdelta(c);
+        if (net != 0) cout << "cash not conserved: " << net << "\n";
+        market.reset();
+    }
+
+    cout << "orders_per_product=" << norders << " products=" << nproducts
+         << " threads=" << pool.size() << "\n";
+    cout << "clear_ms=" << best << " ns_per_order=" << best * 1e6 / (norders * nproducts)
+         << " price=" << r.price << " volume=" << r.volume << "\n";
+    return 0;
+}
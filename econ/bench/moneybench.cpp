@@ -0,0 +1,72 @@
+// Benchmark do caixa em ponto fixo: lancar o resultado do turno em todas as
+// contas com CashBook::apply (um laco vetorizavel) contra um addcash por
+// company, e lancamentos soltos com CashBook::post. Confere que os tres
+// caminhos chegam aos mesmos saldos e que a saturacao e contada.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target moneybench
+// Uso: ./moneybench [contas] [repeticoes]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "cashbook.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t naccounts = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+    int reps = argc > 2 ? atoi(argv[2]) : 100;
+
+    std::vector<int64_t> deltas(naccounts);
+    std::vector<CashBook::Posting> postings(naccounts);
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < naccounts; i++){
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        deltas[i] = (int64_t)(state % 2000001) - 1000000; // +-10000.00
+        postings[naccounts - 1 - i] = CashBook::Posting{(uint32_t)i, deltas[i]};
+    }
+
+    CashBook single, batch, loose;
+    for (size_t i = 0; i < naccounts; i++){
+        single.open(Money::units(1000));
+        batch.open(Money::units(1000));
+        loose.open(Money::units(1000));
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++){
+        for (size_t i = 0; i < naccounts; i++) single.add((uint32_t)i, Money::fromCents(deltas[i]));
+    }
+    auto t1 = chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) batch.apply(deltas.data(), naccounts);
+    auto t2 = chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) loose.post(postings.data(), naccounts);
+    auto t3 = chrono::steady_clock::now();
+
+    bool match = true;
+    for (size_t i = 0; match && i < naccounts; i++){
+        match = single.balance((uint32_t)i) == batch.balance((uint32_t)i)
+             && batch.balance((uint32_t)i) == loose.balance((uint32_t)i);
+    }
+
+    // Saturacao: uma conta perto do limite recebe mais um credito.
+    CashBook edge;
+    edge.open(Money::fromCents(Money::max - 5));
+    edge.open(Money::fromCents(Money::min + 5));
+    int64_t push[2] = {10, -10};
+    size_t saturated = edge.apply(push, 2);
+    bool clamped = edge.balance(0).cents == Money::max && edge.balance(1).cents == Money::min;
+
+    double n = (double)naccounts * reps;
+    cout << "accounts=" << naccounts << " reps=" << reps << "\n";
+    cout << "addcash_ns=" << chrono::duration<double, nano>(t1 - t0).count() / n
+         << " apply_ns=" << chrono::duration<double, nano>(t2 - t1).count() / n
+         << " post_ns=" << chrono::duration<double, nano>(t3 - t2).count() / n << "\n";
+    cout << "balances_match=" << (match ? "yes" : "NO")
+         << " saturated=" << saturated << " clamped=" << (clamped ? "yes" : "NO")
+         << " fee_1.15x20=" << Money::units(20).scaled(1.15) << "\n";
+    return 0;
+}
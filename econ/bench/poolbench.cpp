@@ -0,0 +1,66 @@
+// Benchmark do ObjectPool: criacao de buildings com new e com o pool,
+// contando as chamadas ao operator new global.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target poolbench
+// Uso: ./poolbench [buildings]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "buildings.hpp"
+#include "pool.hpp"
+
+using namespace std;
+
+static uint64_t g_allocs = 0;
+
+void* operator new(size_t size)
+{
+    g_allocs++;
+    void* p = malloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+int main(int argc, char* argv[])
+{
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::vector<Building*> heap;
+    heap.reserve(n);
+    uint64_t a0 = g_allocs;
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++){
+        heap.push_back(new Building(1, "farm"));
+    }
+    auto t1 = chrono::steady_clock::now();
+    uint64_t heapallocs = g_allocs - a0;
+    for (Building* b : heap) delete b;
+
+    ObjectPool<Building> pool;
+    a0 = g_allocs;
+    auto t2 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++){
+        pool.create(1, "farm");
+    }
+    auto t3 = chrono::steady_clock::now();
+    uint64_t poolallocs = g_allocs - a0;
+    PoolStats stats = pool.stats();
+
+    auto t4 = chrono::steady_clock::now();
+    pool.clear();
+    auto t5 = chrono::steady_clock::now();
+
+    cout << "buildings=" << n << "\n";
+    cout << "new:  ns_per_op=" << chrono::duration<double, nano>(t1 - t0).count() / n
+         << " allocs_per_op=" << (double)heapallocs / n << "\n";
+    cout << "pool: ns_per_op=" << chrono::duration<double, nano>(t3 - t2).count() / n
+         << " allocs_per_op=" << (double)poolallocs / n
+         << " allocs=" << poolallocs << " blocks=" << stats.blocks << "\n";
+    cout << "pool clear_ms=" << chrono::duration<double, milli>(t5 - t4).count() << "\n";
+    return 0;
+}
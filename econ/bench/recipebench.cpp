@@ -0,0 +1,93 @@
+// Benchmark do RecipeBook: cadeia de producao profunda, custo recalculado
+// por completo contra so o caminho que mudou.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target recipebench
+// Uso: ./recipebench [niveis] [produtos por nivel] [ingredientes por produto]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include "recipes.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t levels = argc > 1 ? strtoull(argv[1], nullptr, 10) : 60;
+    size_t width = argc > 2 ? strtoull(argv[2], nullptr, 10) : 100;
+    size_t fanin = argc > 3 ? strtoull(argv[3], nullptr, 10) : 3;
+
+    uint64_t state = 88172645463325252ull;
+    auto rnd = [&](){ state ^= state << 13; state ^= state >> 7; state ^= state << 17; return state; };
+
+    // Nivel 0 sao materias-primas; cada produto do nivel L usa "fanin"
+    // produtos do nivel L-1.
+    RecipeBook book;
+    for (size_t l = 0; l < levels; l++){
+        for (size_t w = 0; w < width; w++){
+            uint32_t p = book.addProduct("p" + std::to_string(l) + "_" + std::to_string(w), 1 + (int64_t)(rnd() % 10));
+            if (l == 0) continue;
+            std::vector<RecipeBook::Ingredient> ing;
+            for (size_t k = 0; k < fanin; k++){
+                ing.push_back(RecipeBook::Ingredient{(uint32_t)((l - 1) * width + rnd() % width), 1});
+            }
+            book.setRecipe(p, ing);
+        }
+    }
+    size_t n = book.size();
+
+    auto t0 = chrono::steady_clock::now();
+    size_t full = book.update(); // primeira vez: tudo sujo
+    auto t1 = chrono::steady_clock::now();
+
+    // Muda o custo de um produto perto do topo: poucos dependentes.
+    const int rounds = 1000;
+    size_t toptouched = 0;
+    auto t2 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++){
+        book.setBaseCost((uint32_t)((levels - 2) * width + rnd() % width), 1 + (int64_t)(rnd() % 10));
+        toptouched += book.update();
+    }
+    auto t3 = chrono::steady_clock::now();
+
+    // Muda uma materia-prima: afeta boa parte da cadeia.
+    size_t rawtouched = 0;
+    auto t4 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++){
+        book.setBaseCost((uint32_t)(rnd() % width), 1 + (int64_t)(rnd() % 10));
+        rawtouched += book.update();
+    }
+    auto t5 = chrono::steady_clock::now();
+
+    // Ingrediente repetido na receita: conta como um so, com a soma.
+    RecipeBook small;
+    uint32_t a = small.addProduct("a", 1), c = small.addProduct("c", 1), b = small.addProduct("b", 2);
+    small.setRecipe(a, {{b, 1}, {b, 2}});
+    small.setRecipe(c, {{a, 1}});
+    std::vector<int64_t> need;
+    small.needs(c, 1, need);
+    bool duplicates = need[b] == 3 && need[a] == 1 && small.cost(c) == 1 + 1 + 3 * 2;
+
+    // Cadeia de 60 niveis com 1000 de cada ingrediente: passa de int64 e
+    // deve parar em INT64_MAX, nao dar a volta.
+    RecipeBook deep;
+    uint32_t prev = deep.addProduct("d0", 1);
+    for (int l = 1; l < 60; l++){
+        uint32_t p = deep.addProduct("d" + std::to_string(l), 1);
+        deep.setRecipe(p, {{prev, 1000}});
+        prev = p;
+    }
+    deep.needs(prev, 1000, need);
+    bool saturates = deep.cost(prev) == INT64_MAX && need[0] == INT64_MAX;
+
+    cout << "products=" << n << " levels=" << levels << " fanin=" << fanin
+         << " duplicate_ingredients=" << (duplicates ? "ok" : "WRONG")
+         << " overflow=" << (saturates ? "saturates" : "WRONG") << "\n";
+    cout << "full_update_us=" << chrono::duration<double, micro>(t1 - t0).count()
+         << " touched=" << full << "\n";
+    cout << "near_top_change_us=" << chrono::duration<double, micro>(t3 - t2).count() / rounds
+         << " touched=" << (double)toptouched / rounds << "\n";
+    cout << "raw_material_change_us=" << chrono::duration<double, micro>(t5 - t4).count() / rounds
+         << " touched=" << (double)rawtouched / rounds << "\n";
+    return 0;
+}
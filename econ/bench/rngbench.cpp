@@ -0,0 +1,90 @@
+// Benchmark do gerador contador (Philox4x32-10): confere os vetores de
+// referencia do Random123, que o lote AVX2, o lote escalar e uma
+// RandomStream por entidade dao os mesmos numeros, e que preencher a coluna
+// em paralelo (pedacos em qualquer ordem e thread) da o mesmo resultado
+// que em serie. Mede ns por numero de cada caminho.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target rngbench
+// Uso: ./rngbench [entidades] [repeticoes] [threads]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "rng.hpp"
+#include "threadpool.hpp"
+
+using namespace std;
+
+static bool known(const uint32_t ctr[4], const uint32_t key[2], const uint32_t expect[4])
+{
+    uint32_t out[4];
+    Philox::block(ctr, key, out);
+    return out[0] == expect[0] && out[1] == expect[1] && out[2] == expect[2] && out[3] == expect[3];
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 20;
+    size_t threads = argc > 3 ? strtoull(argv[3], nullptr, 10) : 0;
+    const uint64_t seed = 20240501;
+    const uint64_t turn = 17;
+
+    // Vetores de referencia do Random123 (kat_vectors, philox4x32_10).
+    const uint32_t c0[4] = {0, 0, 0, 0}, k0[2] = {0, 0};
+    const uint32_t e0[4] = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    const uint32_t c1[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, k1[2] = {0xffffffff, 0xffffffff};
+    const uint32_t e1[4] = {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+    const uint32_t c2[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, k2[2] = {0xa4093822, 0x299f31d0};
+    const uint32_t e2[4] = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+    bool kat = known(c0, k0, e0) && known(c1, k1, e1) && known(c2, k2, e2);
+
+    // uniqueIDs esparsos, como ficam depois de criar e demolir.
+    std::vector<uint64_t> ids(n);
+    for (size_t i = 0; i < n; i++) ids[i] = 1 + i * 3 + (i >> 10);
+    std::vector<uint32_t> stream(n), scalar(n), bulk(n), parallel(n);
+    const char* best = RandomBulk::kernelName();
+
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++){
+        for (size_t i = 0; i < n; i++) stream[i] = RandomStream(seed, turn, ids[i], RngDemand).next32();
+    }
+    auto t1 = chrono::steady_clock::now();
+    RandomBulk::setKernel(RandomBulk::scalarKernel());
+    for (int r = 0; r < reps; r++) RandomBulk::fill32(seed, turn, RngDemand, ids.data(), n, scalar.data());
+    auto t2 = chrono::steady_clock::now();
+    RandomBulk::Kernel avx2 = RandomBulk::avx2Kernel();
+    if (avx2 != nullptr) RandomBulk::setKernel(avx2);
+    for (int r = 0; r < reps; r++) RandomBulk::fill32(seed, turn, RngDemand, ids.data(), n, bulk.data());
+    auto t3 = chrono::steady_clock::now();
+
+    // Pedacos pequenos e fora de ordem: cada numero so depende da entidade.
+    ThreadPool pool(threads);
+    pool.parallelFor(n, 4093, [&](size_t begin, size_t end, size_t){
+        RandomBulk::fill32(seed, turn, RngDemand, ids.data() + begin, end - begin, parallel.data() + begin);
+    });
+
+    bool match = true;
+    for (size_t i = 0; match && i < n; i++){
+        match = stream[i] == scalar[i] && scalar[i] == bulk[i] && bulk[i] == parallel[i];
+    }
+
+    // Finalidades e turnos diferentes nao podem repetir a sequencia.
+    RandomStream a(seed, turn, ids[0], RngDemand), b(seed, turn, ids[0], RngResearch), c(seed, turn + 1, ids[0], RngDemand);
+    uint32_t x = a.next32();
+    bool distinct = x != b.next32() && x != c.next32();
+
+    // Media de uniform() deve ficar perto de 0.5.
+    double sum = 0;
+    RandomStream u(seed, turn, 0, RngProduction);
+    for (size_t i = 0; i < n; i++) sum += u.uniform();
+
+    double total = (double)n * reps;
+    cout << "entities=" << n << " reps=" << reps << " threads=" << pool.size() << " kernel=" << best << "\n";
+    cout << "stream_ns=" << chrono::duration<double, nano>(t1 - t0).count() / total
+         << " bulk_scalar_ns=" << chrono::duration<double, nano>(t2 - t1).count() / total
+         << " bulk_" << (avx2 != nullptr ? "avx2" : "scalar") << "_ns=" << chrono::duration<double, nano>(t3 - t2).count() / total << "\n";
+    cout << "kat=" << (kat ? "yes" : "NO") << " values_match=" << (match ? "yes" : "NO")
+         << " purposes_distinct=" << (distinct ? "yes" : "NO") << " mean_uniform=" << sum / n << "\n";
+    return 0;
+}
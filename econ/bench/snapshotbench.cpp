@@ -0,0 +1,98 @@
+// Benchmark do snapshot binario: salva um mundo grande, depois mede abrir
+// o arquivo (mmap + leitura direta das colunas) e recarregar o Manager.
+// Carregar usa as colunas no lugar e deixa os Buildings para o primeiro
+// uso: manager_load_ms e o carregar, materialize_ms a primeira leitura de
+// buildings(). columns_copy_ms e a copia antiga das colunas, para comparar.
+// lazy_agrees: depois de um turno, o mundo carregado bate com o original.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target snapshotbench
+// Uso: ./snapshotbench [buildings] [companies] [arquivo]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include "manager.hpp"
+#include "snapshot.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t nbuildings = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t ncompanies = argc > 2 ? strtoull(argv[2], nullptr, 10) : 100;
+    std::string path = argc > 3 ? argv[3] : "snapshotbench.bin";
+    cout.setstate(ios::failbit); // silencia as mensagens do Manager
+
+    Manager runner;
+    for (size_t c = 0; c < ncompanies; c++){
+        runner.criarCompany("company" + std::to_string(c));
+    }
+    for (size_t i = 0; i < nbuildings; i++){
+        if (i % (nbuildings / ncompanies + 1) == 0) runner.selectCompany((int)(i * ncompanies / nbuildings));
+        runner.criabuilding(1 + (int)(i % 3), "predio");
+    }
+    runner.passarturno();
+
+    auto t0 = chrono::steady_clock::now();
+    bool saved = runner.salvar(path);
+    auto t1 = chrono::steady_clock::now();
+
+    // Abrir e somar uma coluna inteira direto do mapeamento.
+    SnapshotFile file;
+    bool opened = file.open(path);
+    int64_t stock = 0;
+    if (opened){
+        const int32_t* col = file.column(ColStock);
+        for (uint64_t i = 0; i < file.header().nbuildings; i++) stock += col[i];
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    TurnEngine engine;
+    if (opened){
+        const SnapshotHeader& h = file.header();
+        engine.restore(h.nbuildings, file.column(ColProduction), file.column(ColDemand),
+                       file.column(ColStock), file.column(ColPrice), file.column(ColCost),
+                       file.column(ColOwner), h.turn);
+    }
+    auto t2b = chrono::steady_clock::now();
+
+    Manager loaded;
+    bool restored = loaded.carregar(path);
+    auto t3 = chrono::steady_clock::now();
+    double loadms = chrono::duration<double, milli>(t3 - t2b).count();
+    double copyms = chrono::duration<double, milli>(t2b - t2).count();
+
+    // Turno sem Buildings criados, depois a primeira leitura do registro.
+    runner.passarturno();
+    loaded.passarturno();
+    runner.sync();
+    loaded.sync();
+    bool agrees = loaded.engine().size() == runner.engine().size();
+    const BuildingColumns& a = runner.engine().columns();
+    const BuildingColumns& b = loaded.engine().columns();
+    for (size_t i = 0; agrees && i < a.stock.size(); i++){
+        agrees = a.stock[i] == b.stock[i] && a.income[i] == b.income[i] && a.owner[i] == b.owner[i];
+    }
+    auto t4 = chrono::steady_clock::now();
+    size_t materialized = loaded.buildings().size();
+    auto t5 = chrono::steady_clock::now();
+    agrees = agrees && materialized == nbuildings;
+    for (size_t c = 0; agrees && c < ncompanies; c++){
+        agrees = loaded.getcompany((int)c)->buildings().size() == runner.getcompany((int)c)->buildings().size()
+              && loaded.getcompany((int)c)->getcash().cents == runner.getcompany((int)c)->getcash().cents;
+    }
+
+    cout.clear();
+    cout << "buildings=" << nbuildings << " companies=" << ncompanies
+         << " saved=" << saved << " opened=" << opened << " restored=" << restored << "\n";
+    cout << "save_ms=" << chrono::duration<double, milli>(t1 - t0).count()
+         << " mmap_open_and_scan_ms=" << chrono::duration<double, milli>(t2 - t1).count()
+         << " manager_load_ms=" << loadms
+         << " stock_sum=" << stock << "\n";
+    cout << "columns_copy_ms=" << copyms
+         << " materialize_ms=" << chrono::duration<double, milli>(t5 - t4).count()
+         << " load_ns_per_building=" << loadms * 1e6 / nbuildings
+         << " lazy_agrees=" << (agrees ? "yes" : "NO") << "\n";
+    remove(path.c_str());
+    return 0;
+}
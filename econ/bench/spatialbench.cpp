@@ -0,0 +1,119 @@
+// Benchmark do SpatialIndex: consultas de raio e de vizinho mais proximo
+// contra a varredura de todos os buildings (que tambem confere o resultado).
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target spatialbench
+// Uso: ./spatialbench [buildings] [tamanho do mapa] [consultas]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include "spatial.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    int32_t side = argc > 2 ? atoi(argv[2]) : 10000;
+    size_t nqueries = argc > 3 ? strtoull(argv[3], nullptr, 10) : 2000;
+
+    uint64_t state = 88172645463325252ull;
+    auto rnd = [&](){ state ^= state << 13; state ^= state >> 7; state ^= state << 17; return state; };
+
+    SpatialIndex index;
+    std::vector<SpatialIndex::Entry> all(n);
+    for (size_t i = 0; i < n; i++){
+        all[i] = SpatialIndex::Entry{makeHandle((uint32_t)i, 1), (int32_t)(rnd() % side), (int32_t)(rnd() % side), 1 + (int32_t)(rnd() % 3)};
+        index.insert(all[i].handle, all[i].x, all[i].y, all[i].type);
+    }
+
+    std::vector<int32_t> qx(nqueries), qy(nqueries);
+    for (size_t q = 0; q < nqueries; q++){ qx[q] = (int32_t)(rnd() % side); qy[q] = (int32_t)(rnd() % side); }
+    const int32_t radius = 50;
+    const uint32_t farms = 1u << 1;
+
+    std::vector<SpatialIndex::Entry> out;
+    size_t found = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (size_t q = 0; q < nqueries; q++){
+        index.within(qx[q], qy[q], radius, out);
+        found += out.size();
+    }
+    auto t1 = chrono::steady_clock::now();
+    std::vector<Handle> nearest(nqueries);
+    for (size_t q = 0; q < nqueries; q++) nearest[q] = index.nearest(qx[q], qy[q], farms);
+    auto t2 = chrono::steady_clock::now();
+
+    // Varredura completa, so nas primeiras consultas.
+    size_t nscan = nqueries < 100 ? nqueries : 100;
+    size_t scanfound = 0, mismatches = 0;
+    auto t3 = chrono::steady_clock::now();
+    for (size_t q = 0; q < nscan; q++){
+        int64_t bestd2 = -1;
+        for (const SpatialIndex::Entry& e : all){
+            int64_t dx = e.x - qx[q], dy = e.y - qy[q], d2 = dx * dx + dy * dy;
+            if (d2 <= (int64_t)radius * radius) scanfound++;
+            if (e.type == 1 && (bestd2 < 0 || d2 < bestd2)) bestd2 = d2;
+        }
+        const SpatialIndex::Entry& got = all[handleIndex(nearest[q])];
+        int64_t dx = got.x - qx[q], dy = got.y - qy[q];
+        if (dx * dx + dy * dy != bestd2) mismatches++;
+    }
+    auto t4 = chrono::steady_clock::now();
+
+    size_t firstfound = 0;
+    for (size_t q = 0; q < nscan; q++){ index.within(qx[q], qy[q], radius, out); firstfound += out.size(); }
+
+    // Mundo esparso: poucos buildings espalhados pelo int32 inteiro. Os
+    // aneis e o retangulo cobririam bilhoes de celulas; tem que custar o
+    // mesmo que varrer as celulas. Tipo 7 nao existe, tipo 2 e raro.
+    SpatialIndex sparse;
+    std::vector<SpatialIndex::Entry> few(2000);
+    for (size_t i = 0; i < few.size(); i++){
+        few[i] = SpatialIndex::Entry{makeHandle((uint32_t)i, 1), (int32_t)(uint32_t)rnd(), (int32_t)(uint32_t)rnd(), i % 500 == 0 ? 2 : 1};
+        sparse.insert(few[i].handle, few[i].x, few[i].y, few[i].type);
+    }
+    const size_t nsparse = 200;
+    std::vector<int32_t> sx(nsparse), sy(nsparse);
+    std::vector<Handle> missing(nsparse), rare(nsparse);
+    std::vector<size_t> inrange(nsparse);
+    for (size_t q = 0; q < nsparse; q++){ sx[q] = (int32_t)(uint32_t)rnd(); sy[q] = (int32_t)(uint32_t)rnd(); }
+    auto t5 = chrono::steady_clock::now();
+    for (size_t q = 0; q < nsparse; q++){
+        missing[q] = sparse.nearest(sx[q], sy[q], 1u << 7);
+        rare[q] = sparse.nearest(sx[q], sy[q], 1u << 2);
+        sparse.within(sx[q], sy[q], 1 << 30, out);
+        inrange[q] = out.size();
+    }
+    auto t6 = chrono::steady_clock::now();
+
+    auto dist2 = [](int64_t dx, int64_t dy){ // saturada, como no indice
+        uint64_t ax = (uint64_t)(dx < 0 ? -dx : dx), ay = (uint64_t)(dy < 0 ? -dy : dy);
+        uint64_t a = ax * ax, b = ay * ay;
+        return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+    };
+    size_t sparsebad = 0;
+    for (size_t q = 0; q < nsparse; q++){
+        uint64_t bestd2 = UINT64_MAX;
+        size_t expect = 0;
+        for (const SpatialIndex::Entry& e : few){
+            uint64_t d2 = dist2((int64_t)e.x - sx[q], (int64_t)e.y - sy[q]);
+            if (e.type == 2 && d2 < bestd2) bestd2 = d2;
+            if (d2 <= (uint64_t)1 << 60) expect++;
+        }
+        const SpatialIndex::Entry& got = few[handleIndex(rare[q])];
+        if (missing[q] != NullHandle || inrange[q] != expect
+            || dist2((int64_t)got.x - sx[q], (int64_t)got.y - sy[q]) != bestd2) sparsebad++;
+    }
+
+    cout << "buildings=" << n << " side=" << side << " queries=" << nqueries << "\n";
+    cout << "within_r" << radius << "_us=" << chrono::duration<double, micro>(t1 - t0).count() / nqueries
+         << " nearest_farm_us=" << chrono::duration<double, micro>(t2 - t1).count() / nqueries
+         << " full_scan_us=" << chrono::duration<double, micro>(t4 - t3).count() / nscan << "\n";
+    cout << "avg_found=" << (double)found / nqueries
+         << " scan_agrees=" << (scanfound == firstfound && mismatches == 0 ? "yes" : "NO") << "\n";
+    cout << "sparse_buildings=" << few.size() << " sparse_3queries_us=" << chrono::duration<double, micro>(t6 - t5).count() / nsparse
+         << " sparse_agrees=" << (sparsebad == 0 ? "yes" : "NO") << "\n";
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Benchmark do TurnEngine: um turno sobre N buildings, de 1 ate T threads.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target turnbench
+// Uso: ./turnbench [buildings] [companies] [turnos] [threads]
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "turnengine.hpp"
+#include "threadpool.hpp"
+
+using namespace std;
+
+// Companies de tamanhos bem diferentes: a company c tem ~1/(c+1) dos buildings.
+static void fill(TurnEngine& engine, size_t nbuildings, size_t ncompanies)
+{
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < nbuildings; i++){
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        size_t owner = (size_t)(state % ncompanies);
+        owner = (owner * owner) / ncompanies; // concentra nas primeiras
+        engine.addBuilding(1 + (int)(i % 3), (int)owner);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t nbuildings = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t ncompanies = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000;
+    int nturns = argc > 3 ? atoi(argv[3]) : 50;
+    size_t maxthreads = argc > 4 ? strtoull(argv[4], nullptr, 10) : std::thread::hardware_concurrency();
+    if (maxthreads == 0) maxthreads = 1;
+
+    cout << "buildings=" << nbuildings << " companies=" << ncompanies
+         << " turns=" << nturns << "\n";
+
+    std::vector<int64_t> reference;
+    double base = 0;
+    // Dobra ate maxthreads e termina sempre com maxthreads (3, 5, 6...).
+    for (size_t threads = 1; threads <= maxthreads;
+         threads = threads == maxthreads ? maxthreads + 1 : std::min(threads * 2, maxthreads)){
+        TurnEngine engine;
+        engine.setIncremental(false); // laco cheio; o incremental fica no dirtybench
+        fill(engine, nbuildings, ncompanies);
+        ThreadPool pool(threads);
+
+        engine.run(ncompanies, &pool); // aquecimento
+        double best = 1e30, total = 0;
+        for (int t = 0; t < nturns; t++){
+            auto start = chrono::steady_clock::now();
+            engine.run(ncompanies, &pool);
+            auto end = chrono::steady_clock::now();
+            double ms = chrono::duration<double, milli>(end - start).count();
+            total += ms;
+            if (ms < best) best = ms;
+        }
+
+        // Mesmo resultado para qualquer numero de threads.
+        std::vector<int64_t> result(ncompanies);
+        for (size_t c = 0; c < ncompanies; c++) result[c] = engine.cashdelta(c);
+        if (threads == 1){
+            reference = result;
+            base = best;
+        }
+
+        cout << "threads=" << threads << " best_ms=" << best
+             << " mean_ms=" << total / nturns
+             << " ns_per_building=" << best * 1e6 / nbuildings
+             << " speedup=" << base / best
+             << " deterministic=" << (result == reference ? "yes" : "NO") << "\n";
+    }
+    return 0;
+}
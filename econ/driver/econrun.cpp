@@ -0,0 +1,133 @@
+// Driver sem interface para rodadas em lote: monta um mundo (gerado pela
+// semente ou por um script), roda N turnos e imprime uma linha chave=valor.
+// Usa so a biblioteca do nucleo, a mesma do console e do app Qt.
+// Compilar: cmake -S .. -B ../build && cmake --build ../build --target econrun
+// Uso: ./econrun [--companies N] [--buildings N] [--turns N] [--seed S]
+//                [--script arquivo] [--trace arquivo] [--save arquivo] [--journal arquivo]
+//   --script   monta o mundo com os comandos do arquivo em vez de gerar
+//   --trace    liga o profiler e grava o Chrome trace (e arquivo.csv)
+//   --save     grava o snapshot do mundo no fim
+//   --journal  abre o FirmBook (por padrao roda sem livro-caixa)
+
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "manager.hpp"
+#include "script.hpp"
+#include "profiler.hpp"
+
+using namespace std;
+
+namespace {
+    class NullBuffer : public std::streambuf {
+        protected:
+            int overflow(int c) override { return c; }
+            std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    struct Options {
+        size_t companies = 10;
+        size_t buildings = 100000;
+        size_t turns = 100;
+        uint64_t seed = 1;
+        std::string script, trace, save, journal;
+    };
+
+    bool parse(int argc, char* argv[], Options& o)
+    {
+        for (int i = 1; i < argc; i++){
+            if (i + 1 >= argc) return false;
+            const char* k = argv[i];
+            const char* v = argv[++i];
+            if (strcmp(k, "--companies") == 0) o.companies = strtoull(v, nullptr, 10);
+            else if (strcmp(k, "--buildings") == 0) o.buildings = strtoull(v, nullptr, 10);
+            else if (strcmp(k, "--turns") == 0) o.turns = strtoull(v, nullptr, 10);
+            else if (strcmp(k, "--seed") == 0) o.seed = strtoull(v, nullptr, 10);
+            else if (strcmp(k, "--script") == 0) o.script = v;
+            else if (strcmp(k, "--trace") == 0) o.trace = v;
+            else if (strcmp(k, "--save") == 0) o.save = v;
+            else if (strcmp(k, "--journal") == 0) o.journal = v;
+            else return false;
+        }
+        return o.companies > 0 || !o.script.empty();
+    }
+
+    // Mundo gerado: posicao e tipo de cada building sorteados pela
+    // sequencia dele (RngWorldGen, turno 0), entao a mesma semente da
+    // sempre o mesmo mundo.
+    void generate(Manager& world, const Options& o)
+    {
+        for (size_t i = 0; i < o.companies; i++) world.criarCompany("company" + std::to_string(i));
+        int side = 1;
+        while ((size_t)side * side < o.buildings) side *= 2;
+        for (size_t i = 0; i < o.buildings; i++){
+            if (i % 100 == 0) world.selectCompany((int)(i / 100 % o.companies));
+            RandomStream r = world.random(i, RngWorldGen);
+            int type = r.range(1, 3);
+            int x = r.range(0, side - 1);
+            world.criabuilding(type, "predio", x, r.range(0, side - 1));
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options o;
+    if (!parse(argc, argv, o)){
+        fprintf(stderr, "uso: econrun [--companies N] [--buildings N] [--turns N] [--seed S] "
+                        "[--script arquivo] [--trace arquivo] [--save arquivo] [--journal arquivo]\n");
+        return 2;
+    }
+
+    NullBuffer null;
+    std::streambuf* console = cout.rdbuf(&null); // o Manager fala muito
+
+    Manager world;
+    world.setSeed(o.seed);
+    if (!o.journal.empty()) world.abrirlivro(o.journal);
+    if (!o.script.empty()){
+        FILE* input = fopen(o.script.c_str(), "rb");
+        if (input == nullptr){
+            cout.rdbuf(console);
+            fprintf(stderr, "econrun: cannot open %s\n", o.script.c_str());
+            return 1;
+        }
+        ScriptRunner script(world);
+        bool ok = script.run(input);
+        fclose(input);
+        if (!ok){
+            cout.rdbuf(console);
+            fprintf(stderr, "econrun: script %s failed\n", o.script.c_str());
+            return 1;
+        }
+    } else {
+        generate(world, o);
+    }
+
+    Profiler::enabled = !o.trace.empty();
+    auto start = chrono::steady_clock::now();
+    for (size_t t = 0; t < o.turns; t++) world.passarturno();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    Profiler::enabled = false;
+
+    bool ok = true;
+    if (!o.trace.empty()) ok = Profiler::exportChromeTrace(o.trace) && Profiler::exportCsv(o.trace + ".csv") && ok;
+    if (!o.save.empty()) ok = world.salvar(o.save) && ok;
+
+    Money cash;
+    for (size_t i = 0; i < world.ncompanies(); i++) cash += world.getcompany((int)i)->getcash();
+    size_t nbuildings = world.buildings().size();
+    cout.rdbuf(console);
+
+    double buildingturns = (double)nbuildings * o.turns;
+    printf("econrun buildings=%zu companies=%zu turns=%zu seconds=%.4f turns_per_s=%.1f ns_per_building_turn=%.3f cash_total=%s\n",
+           nbuildings, world.ncompanies(), o.turns, seconds,
+           seconds > 0 ? o.turns / seconds : 0.0,
+           buildingturns > 0 ? seconds * 1e9 / buildingturns : 0.0,
+           cash.str().c_str());
+    if (!ok) fprintf(stderr, "econrun: could not write output files\n");
+    return ok ? 0 : 1;
+}
@@ -7,25 +7,77 @@
 
 #include <iostream>
 #include "buildings.hpp"
+#include "log.hpp"
 
 using namespace std;
 
-int IDGenerator::getnewID() {
-      return ++_counter;
+namespace {
+  // Bloco de IDs reservado pela thread: entrega next..end sem tocar no atomico.
+  struct IDBlock {
+    uint64_t next = 0;
+    uint64_t end = 0;
+    uint64_t epoch = 0;
+  };
+
+  uint64_t take(IDBlock& block, std::atomic<uint64_t>& counter) {
+    uint64_t epoch = IDGenerator::epoch.load(std::memory_order_relaxed);
+    if (block.next == block.end || block.epoch != epoch) {
+      block.epoch = epoch;
+      uint64_t base = counter.fetch_add(IDGenerator::blocksize, std::memory_order_relaxed);
+      block.next = base + 1; // IDs comecam em 1
+      block.end = base + 1 + IDGenerator::blocksize;
+    }
+    return block.next++;
+  }
+}
+
+uint64_t IDGenerator::getnewID() {
+      static thread_local IDBlock block;
+      return take(block, _counter);
+}
+
+uint64_t IDGenerator::getnewProductID() {
+      static thread_local IDBlock block;
+      return take(block, _productcounter);
 }
 
-int IDGenerator::_counter = 0;
+// Usado ao carregar um mundo salvo: o contador pula para depois do maior ID
+// restaurado e os blocos ja reservados pelas threads sao descartados.
+void IDGenerator::advance(uint64_t id) {
+      uint64_t current = _counter.load();
+      while (current < id && !_counter.compare_exchange_weak(current, id)) {
+      }
+      epoch.fetch_add(1);
+}
+
+std::atomic<uint64_t> IDGenerator::_counter(0);
+std::atomic<uint64_t> IDGenerator::_productcounter(0);
+std::atomic<uint64_t> IDGenerator::epoch(0);
 
 
-Building::Building(int type, std::string objnome)
+Building::Building(int type, std::string_view objnome, int x, int y, uint64_t id)
 {
-  _uniqueID = IDGenerator::getnewID();
+  _uniqueID = (id != 0) ? id : IDGenerator::getnewID();
   _type = type;
-  _nome = objnome;
-  cout << "building (" << this << ") constructed!" << endl;
-  cout << "UID = "<< (this -> _uniqueID) << endl;
+  _nome = Interner::intern(objnome);
+  _size = 1;
+  _location[0] = x;
+  _location[1] = y;
+  _engine = nullptr;
+  _slot = 0;
+  _handle = NullHandle;
+  _ownerpos = 0;
+  ELOG_DEBUG("building (" << this << ") constructed!");
+  ELOG_DEBUG("UID = " << _uniqueID);
 }
 
-void Building::produce(){
+void Building::attach(TurnEngine* engine, size_t slot){
+  _engine = engine;
+  _slot = slot;
+}
 
+void Building::produce(){
+  if (_engine != nullptr){
+    _engine->produce(_slot);
+  }
 }
\ No newline at end of file
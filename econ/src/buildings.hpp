@@ -1,13 +1,25 @@
 #pragma once
 #include <iostream>
+#include <atomic>
+#include <cstdint>
+#include "turnengine.hpp"
+#include "slotmap.hpp"
+#include "intern.hpp"
 using namespace std;
 
 
+// IDs unicos de 64 bits. Cada thread reserva um bloco de IDs do contador
+// global por vez, assim criar objetos em paralelo nao disputa um unico atomico.
 class IDGenerator {
   private:
-	  static int _counter; //estática da classe para garantir id unico para cada obj
+	  static std::atomic<uint64_t> _counter;        // IDs de buildings
+	  static std::atomic<uint64_t> _productcounter; // uniqueProductID
   public:
-    static int getnewID();
+    static const uint64_t blocksize = 1024;
+    static std::atomic<uint64_t> epoch; // muda quando os blocos reservados devem ser descartados
+    static uint64_t getnewID();
+    static uint64_t getnewProductID();
+    static void advance(uint64_t id); // proximos IDs de building serao > id
 };
 
 
@@ -16,15 +28,33 @@ class Building {
 
   private:
     //static int newID =0; //estática da classe para garantir id unico para cada obj
-    int _uniqueID;
+    uint64_t _uniqueID;
     int _type; // 1 para produtor, 2 para consumidor, 3 para ambos.
     int _size;
     int _location[2];
-    std::string _nome;
+    Symbol _nome;        // nome internado (ver intern.hpp)
+    TurnEngine* _engine; // colunas onde ficam producao, estoque e custo
+    size_t _slot;        // indice deste building nas colunas do engine
+    Handle _handle;      // handle no registro de buildings do Manager
+    size_t _ownerpos;    // posicao na lista de handles da company
 
   public:
-    Building(int type, std::string objnome);
-    int uniqueID() { return _uniqueID; }
-    std::string nome(){return _nome;}
+    Building(int type, std::string_view objnome, int x = 0, int y = 0, uint64_t id = 0);
+    uint64_t uniqueID() { return _uniqueID; }
+    std::string_view nome() const { return Interner::str(_nome); }
+    Symbol nomeSymbol() const { return _nome; }
+    int type() { return _type; }
+    int posx() { return _location[0]; }
+    int posy() { return _location[1]; }
+    size_t slot() { return _slot; }
+    Handle handle() { return _handle; }
+    void attach(TurnEngine* engine, size_t slot);
+    void sethandle(Handle h) { _handle = h; }
+    size_t ownerpos() { return _ownerpos; }
+    void setownerpos(size_t pos) { _ownerpos = pos; }
     void produce();
-};
\ No newline at end of file
+};
+
+// Registro unico de todos os buildings do mundo. O indice denso de cada
+// building e o mesmo slot das colunas do TurnEngine.
+typedef SlotMap<Building*> BuildingRegistry;
\ No newline at end of file
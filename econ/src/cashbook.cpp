@@ -0,0 +1,165 @@
+#include <cstring>
+#include <algorithm>
+#include "cashbook.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ECON_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    typedef uint64_t (*ApplyKernel)(size_t n, const int64_t* old, const int64_t* deltas, int64_t* next);
+
+    // Soma saturada sem desvio: estourou se o resultado tem sinal diferente
+    // das duas parcelas; o limite vem do sinal de a. Retorna quantas saturaram.
+    uint64_t applyScalar(size_t n, const int64_t* old, const int64_t* deltas, int64_t* next)
+    {
+        uint64_t overflowed = 0;
+        for (size_t i = 0; i < n; i++){
+            int64_t a = old[i], b = deltas[i];
+            int64_t r = (int64_t)((uint64_t)a + (uint64_t)b);
+            int64_t over = ((a ^ r) & (b ^ r)) >> 63; // -1 ou 0
+            int64_t limit = (a >> 63) ^ INT64_MAX;    // INT64_MIN se a < 0
+            overflowed -= over;
+            next[i] = (r & ~over) | (limit & over);
+        }
+        return overflowed;
+    }
+
+#ifdef ECON_HAVE_AVX2_KERNEL
+    // SSE2 nao tem comparacao de 64 bits, entao o laco acima fica escalar
+    // sem AVX2 (vpcmpgtq); aqui 4 contas por instrucao.
+    __attribute__((target("avx2,popcnt")))
+    uint64_t applyAvx2(size_t n, const int64_t* old, const int64_t* deltas, int64_t* next)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i vmax = _mm256_set1_epi64x(INT64_MAX);
+        uint64_t overflowed = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4){
+            __m256i a = _mm256_loadu_si256((const __m256i*)(old + i));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(deltas + i));
+            __m256i r = _mm256_add_epi64(a, b);
+            __m256i x = _mm256_and_si256(_mm256_xor_si256(a, r), _mm256_xor_si256(b, r));
+            __m256i over = _mm256_cmpgt_epi64(zero, x);
+            __m256i limit = _mm256_xor_si256(_mm256_cmpgt_epi64(zero, a), vmax);
+            _mm256_storeu_si256((__m256i*)(next + i), _mm256_blendv_epi8(r, limit, over));
+            overflowed += (uint64_t)__builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(over)));
+        }
+        return overflowed + applyScalar(n - i, old + i, deltas + i, next + i);
+    }
+#endif
+
+    ApplyKernel pickKernel(void)
+    {
+#ifdef ECON_HAVE_AVX2_KERNEL
+        if (__builtin_cpu_supports("avx2")) return &applyAvx2;
+#endif
+        return &applyScalar;
+    }
+
+    const ApplyKernel applyKernel = pickKernel();
+}
+
+CashBook::CashBook(void)
+{
+    _journal = nullptr;
+    _saturated = 0;
+}
+
+CashBook::CashBook(const CashBook& o)
+    : _balances(o._balances), _journal(nullptr), _saturated(o._saturated)
+{
+}
+
+CashBook& CashBook::operator=(const CashBook& o)
+{
+    _balances = o._balances;
+    _journal = nullptr;
+    _saturated = o._saturated;
+    return *this;
+}
+
+uint32_t CashBook::open(Money opening)
+{
+    uint32_t account = (uint32_t)_balances.size();
+    _balances.push_back(opening.cents);
+    if (_journal != nullptr) _journal->post(account, FirmBook::Set, opening.cents);
+    return account;
+}
+
+Money CashBook::add(uint32_t account, Money value)
+{
+    int64_t old = _balances[account];
+    int64_t now = Money::satadd(old, value.cents);
+    if (now - old != value.cents) _saturated++;
+    _balances.write(account) = now;
+    if (_journal != nullptr) _journal->post(account, FirmBook::Add, now - old);
+    return Money::fromCents(now);
+}
+
+Money CashBook::sub(uint32_t account, Money value)
+{
+    int64_t old = _balances[account];
+    int64_t now = Money::satsub(old, value.cents);
+    if (old - now != value.cents) _saturated++;
+    _balances.write(account) = now;
+    if (_journal != nullptr) _journal->post(account, FirmBook::Sub, old - now);
+    return Money::fromCents(now);
+}
+
+Money CashBook::set(uint32_t account, Money value)
+{
+    _balances.write(account) = value.cents;
+    if (_journal != nullptr) _journal->post(account, FirmBook::Set, value.cents);
+    return value;
+}
+
+// Um pedaco da coluna por vez: o kernel calcula os saldos novos em _next,
+// o diario recebe as diferencas e so entao o pedaco e escrito (e copiado,
+// se ainda estiver compartilhado com um fork).
+size_t CashBook::apply(const int64_t* deltas, size_t n)
+{
+    if (n > _balances.size()) n = _balances.size();
+    _next.resize(n);
+    uint64_t overflowed = 0;
+    for (size_t c = 0; c * CowColumn<int64_t>::chunksize < n; c++){
+        size_t base = c * CowColumn<int64_t>::chunksize;
+        size_t m = std::min(n - base, CowColumn<int64_t>::chunksize);
+        const int64_t* old = _balances.chunk(c);
+        int64_t* next = _next.data() + base;
+        overflowed += applyKernel(m, old, deltas + base, next);
+        bool changed = false;
+        for (size_t i = 0; i < m; i++){
+            if (next[i] == old[i]) continue;
+            changed = true;
+            if (_journal != nullptr) _journal->post((uint32_t)(base + i), FirmBook::Add, next[i] - old[i]);
+        }
+        if (changed) memcpy(_balances.writechunk(c), next, m * sizeof(int64_t));
+    }
+    _saturated += overflowed;
+    return (size_t)overflowed;
+}
+
+size_t CashBook::post(const Posting* postings, size_t n)
+{
+    _deltas.assign(_balances.size(), 0);
+    size_t overflowed = 0;
+    for (size_t i = 0; i < n; i++){
+        const Posting& p = postings[i];
+        if (p.account >= _deltas.size()) continue;
+        int64_t sum = Money::satadd(_deltas[p.account], p.cents);
+        if (sum - _deltas[p.account] != p.cents) overflowed++;
+        _deltas[p.account] = sum;
+    }
+    _saturated += overflowed;
+    return overflowed + apply(_deltas.data(), _deltas.size());
+}
+
+void CashBook::clear(void)
+{
+    _balances.clear();
+    _next.clear();
+    _deltas.clear();
+    _saturated = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "money.hpp"
+#include "firmbook.hpp"
+#include "cow.hpp"
+
+using namespace std;
+
+// Caixa de todas as companies numa coluna de centavos (int64), indexada
+// pela conta de cada company. Company::addcash e afins sao lancamentos
+// avulsos aqui; o turno lanca todas as contas de uma vez com apply(), num
+// laco sem desvios (AVX2 quando a CPU tem, como no Inventory).
+//
+// Toda soma satura e saturated() conta os estouros. No diario (FirmBook)
+// vai o valor efetivamente lancado, entao o replay bate mesmo saturando.
+//
+// A coluna e copy-on-write: uma copia do CashBook (fork do mundo) e O(1)
+// e sai sem diario, para nao escrever no livro do mundo original.
+class CashBook {
+    public:
+        struct Posting {
+            uint32_t account;
+            int64_t cents; // credito > 0, debito < 0
+        };
+
+        CashBook(void);
+        CashBook(const CashBook& o);
+        CashBook& operator=(const CashBook& o);
+        void attachjournal(FirmBook* journal) { _journal = journal; }
+
+        uint32_t open(Money opening); // nova conta; lanca o saldo de abertura
+        Money balance(uint32_t account) const { return Money::fromCents(_balances[account]); }
+        Money add(uint32_t account, Money value);
+        Money sub(uint32_t account, Money value);
+        Money set(uint32_t account, Money value);
+
+        // deltas[i] (centavos) vai para a conta i, i < n <= size().
+        // Retorna quantas contas saturaram.
+        size_t apply(const int64_t* deltas, size_t n);
+        // Lancamentos soltos, em qualquer ordem e com contas repetidas:
+        // junta por conta e aplica como apply().
+        size_t post(const Posting* postings, size_t n);
+
+        void clear(void);
+        size_t size(void) const { return _balances.size(); }
+        uint64_t saturated(void) const { return _saturated; }
+        const CowColumn<int64_t>& balances(void) const { return _balances; }
+
+    private:
+        CowColumn<int64_t> _balances;
+        std::vector<int64_t> _next;   // saldos novos do apply(), antes do diario
+        std::vector<int64_t> _deltas; // soma por conta do post()
+        FirmBook* _journal;
+        uint64_t _saturated;
+};
@@ -1,44 +1,75 @@
 #include <iostream>
 #include "buildings.hpp"
+#include "log.hpp"
 #include "company.hpp"
 
-Company::Company(std::string name, int cash)
+Company::Company(std::string_view name, Money cash)
 {
-     _name = name;
+     _name = Interner::intern(name);
      _cash = cash;
-     _buildingsCreated = 0;
-     cout << "Company (" << this << ") constructed!" << endl;
-     cout << "Cash = "<< (this -> _cash) << endl;
+     _book = nullptr;
+     _account = 0;
+     ELOG_DEBUG("Company (" << this << ") constructed!");
+     ELOG_DEBUG("Cash = " << _cash);
 }
 
 
-Building* Company::criabuilding(int tipo, std::string objnome)
+Building* Company::criabuilding(BuildingRegistry& registry, int tipo, std::string_view objnome, int x, int y, uint64_t id)
 {
-    Building * tmp = new Building(tipo,objnome);
-    cout << "Building created. Building ID:" << tmp->uniqueID();
-    buildingslist[_buildingsCreated] = tmp;
-    _buildingsCreated++;
-//     ownedBuildings.push_back(tmp);
+    Building * tmp = _buildingpool.create(tipo,objnome,x,y,id);
+    ELOG_DEBUG("Building created. Building ID:" << tmp->uniqueID());
+    tmp->sethandle(registry.insert(tmp));
+    tmp->setownerpos(_buildings.size());
+    _buildings.push_back(tmp->handle());
     return tmp;
 };
 
-void Company::listBuildings(){
-    int i=0;
-    while (i < buildingslist.size()){
-        Building* cbuilding = buildingslist[i];
-        cout<<cbuilding->uniqueID()<<" ";
-        cout<<cbuilding->nome()<<"\n"; 
-        i++;
+// Tira o building do registro e da lista da company (troca com o ultimo)
+// e devolve o objeto ao pool, que reaproveita o espaco no proximo criabuilding.
+void Company::demolebuilding(BuildingRegistry& registry, Building* building)
+{
+    size_t pos = building->ownerpos();
+    Handle last = _buildings.back();
+    _buildings[pos] = last;
+    _buildings.pop_back();
+    if (pos < _buildings.size()){
+        (*registry.get(last))->setownerpos(pos);
     }
-     
+    registry.remove(building->handle());
+    _buildingpool.destroy(building);
 };
 
-int Company::getcash (void){return _cash;};
+void Company::listBuildings(const BuildingRegistry& registry){
+    for (size_t i = 0; i < _buildings.size(); i++){
+        Building* const* cbuilding = registry.get(_buildings[i]);
+        if (cbuilding == nullptr) continue;
+        cout<<i<<" ";
+        cout<<(*cbuilding)->uniqueID()<<" ";
+        cout<<(*cbuilding)->nome()<<"\n";
+    }
+};
 
-std::string Company::getName (void){return _name;};
+// Abre a conta da company no caixa do mundo com o saldo atual.
+void Company::attachbook (CashBook* book){
+    _book = book;
+    if (_book != nullptr) _account = _book->open(_cash);
+};
 
-int Company::addcash (int value){_cash = _cash + value; return _cash;};
+// Lancamentos avulsos; com CashBook o saldo (e o diario) ficam la.
+Money Company::addcash (Money value){
+    if (_book != nullptr) return _book->add(_account, value);
+    _cash += value;
+    return _cash;
+};
 
-int Company::subcash (int value){_cash = _cash - value; return _cash;};
+Money Company::subcash (Money value){
+    if (_book != nullptr) return _book->sub(_account, value);
+    _cash -= value;
+    return _cash;
+};
 
-int Company::setcash (int value){_cash = value; return _cash;};
\ No newline at end of file
+Money Company::setcash (Money value){
+    if (_book != nullptr) return _book->set(_account, value);
+    _cash = value;
+    return _cash;
+};
\ No newline at end of file
@@ -1,27 +1,34 @@
 #pragma once
 #include <iostream>
 #include <vector>
-#include <map>
 #include "buildings.hpp"
-#include "company.hpp"
+#include "pool.hpp"
+#include "cashbook.hpp"
 
 using namespace std;
 
 class Company{
 	private:
-        std::string _name;
-        int _cash;
-        std::vector<Building*> ownedBuildings;
-        std::map<int, Building*> buildingslist;
-        uint16_t _buildingsCreated;
+        Symbol _name;      // nome internado (ver intern.hpp)
+        Money _cash;       // caixa enquanto a company nao tem conta num CashBook
+        std::vector<Handle> _buildings; // handles no BuildingRegistry do Manager
+        ObjectPool<Building> _buildingpool; // buildings da company ficam juntos
+        CashBook* _book;   // caixa do mundo, ou nullptr
+        uint32_t _account; // conta da company no CashBook
     public:
-        Company(std::string name, int cash = 0);
-        std::string getName (void);
-        Building* criabuilding(int tipo, std::string objnome);
-        void listBuildings();
-        int getcash (void);
-        int addcash (int value);
-        int subcash (int value);
-        int setcash (int value);
+        Company(std::string_view name, Money cash = Money());
+        std::string_view getName (void) const { return Interner::str(_name); }
+        Symbol nameSymbol (void) const { return _name; }
+        Building* criabuilding(BuildingRegistry& registry, int tipo, std::string_view objnome, int x = 0, int y = 0, uint64_t id = 0);
+        void demolebuilding(BuildingRegistry& registry, Building* building);
+        void listBuildings(const BuildingRegistry& registry);
+        const std::vector<Handle>& buildings (void) const { return _buildings; }
+        Money getcash (void) const { return _book != nullptr ? _book->balance(_account) : _cash; }
+        Money addcash (Money value);
+        Money subcash (Money value);
+        Money setcash (Money value);
+        void attachbook (CashBook* book);
+        uint32_t account (void) const { return _account; }
+        const PoolStats& poolstats (void) const { return _buildingpool.stats(); }
 
 };
\ No newline at end of file
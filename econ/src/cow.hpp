@@ -0,0 +1,141 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// Coluna copy-on-write em pedacos de 2^ChunkBits valores. Copiar a coluna
+// so copia um ponteiro para a tabela de pedacos; a primeira escrita copia a
+// tabela (um ponteiro por pedaco) e depois so o pedaco escrito. Assim um
+// fork do mundo custa O(1) e so paga pelo que ele muda.
+//
+// Leitura de qualquer thread. Escrita em paralelo so em pedacos distintos
+// e depois de detach(), que deixa a tabela exclusiva desta coluna.
+// T precisa ser copiavel byte a byte (int32_t, int64_t...).
+template <typename T, unsigned ChunkBits = 14>
+class CowColumn {
+    public:
+        static constexpr size_t chunksize = (size_t)1 << ChunkBits;
+        static constexpr size_t chunkmask = chunksize - 1;
+
+    private:
+        typedef std::shared_ptr<T[]> Chunk;
+        typedef std::vector<Chunk> Table;
+        std::shared_ptr<Table> _table;
+        size_t _size;
+        std::atomic<uint64_t> _copies; // pedacos copiados por escrita
+
+        Table& table(void){
+            if (!_table) _table = std::make_shared<Table>();
+            else if (_table.use_count() > 1) _table = std::make_shared<Table>(*_table);
+            return *_table;
+        }
+
+        // use_count() == 1 nao muda por baixo: so quem ja tem o pedaco pode
+        // criar outra referencia para ele.
+        T* own(Table& t, size_t c){
+            if (t[c].use_count() > 1){
+                Chunk copy(new T[chunksize]);
+                std::copy(t[c].get(), t[c].get() + chunksize, copy.get());
+                t[c] = copy;
+                _copies.fetch_add(1, std::memory_order_relaxed);
+            }
+            return t[c].get();
+        }
+
+    public:
+        CowColumn(void) : _size(0), _copies(0) {}
+        CowColumn(const CowColumn& o) : _table(o._table), _size(o._size), _copies(0) {}
+        CowColumn& operator=(const CowColumn& o){
+            _table = o._table;
+            _size = o._size;
+            _copies = 0;
+            return *this;
+        }
+
+        size_t size(void) const { return _size; }
+        bool empty(void) const { return _size == 0; }
+        size_t nchunks(void) const { return (_size + chunkmask) >> ChunkBits; }
+        uint64_t copies(void) const { return _copies.load(std::memory_order_relaxed); }
+
+        const T& operator[](size_t i) const { return (*_table)[i >> ChunkBits][i & chunkmask]; }
+        const T& back(void) const { return (*this)[_size - 1]; }
+        T& write(size_t i) { return own(table(), i >> ChunkBits)[i & chunkmask]; }
+
+        // Pedaco c inteiro (o ultimo pode ter menos de chunksize validos).
+        const T* chunk(size_t c) const { return (*_table)[c].get(); }
+        T* writechunk(size_t c) { return own(table(), c); }
+        void detach(void) { if (_size > 0) table(); }
+
+        void push_back(const T& value){
+            Table& t = table();
+            if ((_size & chunkmask) == 0) t.push_back(Chunk(new T[chunksize]()));
+            own(t, _size >> ChunkBits)[_size & chunkmask] = value;
+            _size++;
+        }
+
+        void pop_back(void){
+            _size--;
+            if ((_size & chunkmask) == 0) table().pop_back();
+        }
+
+        void assign(const T* values, size_t n){
+            _table = std::make_shared<Table>();
+            _size = n;
+            for (size_t begin = 0; begin < n; begin += chunksize){
+                Chunk c(new T[chunksize]());
+                std::copy(values + begin, values + std::min(n, begin + chunksize), c.get());
+                _table->push_back(c);
+            }
+        }
+
+        // Usa n valores que ja estao na memoria de "owner" sem copiar: os
+        // pedacos cheios apontam para la e seguram owner vivo; so o ultimo,
+        // incompleto, e copiado (push_back escreve nele). A memoria precisa
+        // aceitar escrita, own() escreve no lugar quando ninguem mais usa o
+        // pedaco (ex.: mmap privado).
+        template <typename Owner>
+        void share(const std::shared_ptr<Owner>& owner, T* values, size_t n){
+            _table = std::make_shared<Table>();
+            _size = n;
+            size_t full = n >> ChunkBits;
+            _table->reserve(nchunks());
+            for (size_t c = 0; c < full; c++) _table->push_back(Chunk(owner, values + (c << ChunkBits)));
+            if (n & chunkmask){
+                Chunk tail(new T[chunksize]());
+                std::copy(values + (full << ChunkBits), values + n, tail.get());
+                _table->push_back(tail);
+            }
+        }
+
+        void assign(size_t n, const T& value){
+            _table = std::make_shared<Table>();
+            _size = n;
+            for (size_t begin = 0; begin < n; begin += chunksize){
+                Chunk c(new T[chunksize]());
+                std::fill(c.get(), c.get() + std::min(chunksize, n - begin), value);
+                _table->push_back(c);
+            }
+        }
+
+        void clear(void){
+            _table.reset();
+            _size = 0;
+        }
+
+        // Copia [begin, begin + n) para out, pedaco por pedaco.
+        void copyout(size_t begin, size_t n, T* out) const {
+            size_t end = begin + n;
+            while (begin < end){
+                size_t off = begin & chunkmask;
+                size_t m = std::min(end - begin, chunksize - off);
+                std::copy(chunk(begin >> ChunkBits) + off, chunk(begin >> ChunkBits) + off + m, out);
+                out += m;
+                begin += m;
+            }
+        }
+};
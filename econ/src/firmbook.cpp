@@ -0,0 +1,138 @@
+#include <cstring>
+#include "firmbook.hpp"
+
+namespace {
+    const char bookmagic[8] = {'F','I','R','M','B','O','O','K'};
+    const uint32_t bookversion = 2; // 2: valores em centavos (Money)
+
+    struct BookHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordsize;
+    };
+}
+
+FirmBook::FirmBook(void)
+{
+    _file = nullptr;
+    _seq = 0;
+    _groups = 0;
+    _buffer.reserve(groupsize);
+}
+
+FirmBook::~FirmBook(void)
+{
+    close();
+}
+
+bool FirmBook::open(const std::string& path)
+{
+    close();
+    // Diario de outra versao (ex.: em unidades inteiras) nao recebe
+    // lancamentos novos: o replay misturaria as escalas.
+    FILE* existing = fopen(path.c_str(), "rb");
+    uint64_t records = 0;
+    size_t torn = 0;
+    if (existing != nullptr){
+        BookHeader h;
+        size_t got = fread(&h, 1, sizeof(h), existing);
+        fseek(existing, 0, SEEK_END);
+        long size = ftell(existing);
+        fclose(existing);
+        if (got != 0 && (got != sizeof(h) || memcmp(h.magic, bookmagic, 8) != 0
+            || h.version != bookversion || h.recordsize != sizeof(Posting))){
+            return false;
+        }
+        if (got != 0){
+            records = ((uint64_t)size - sizeof(h)) / sizeof(Posting);
+            torn = ((uint64_t)size - sizeof(h)) % sizeof(Posting);
+        }
+    }
+    _file = fopen(path.c_str(), "ab");
+    if (_file == nullptr) return false;
+    fseek(_file, 0, SEEK_END);
+    if (ftell(_file) == 0){
+        BookHeader h;
+        memcpy(h.magic, bookmagic, 8);
+        h.version = bookversion;
+        h.recordsize = sizeof(Posting);
+        if (fwrite(&h, sizeof(h), 1, _file) != 1){
+            close();
+            return false;
+        }
+    }
+    // Registro final incompleto (gravacao interrompida): completa com zeros
+    // para os novos nao ficarem desalinhados. O Reset abaixo anula o que
+    // ele tiver.
+    if (torn != 0){
+        char zeros[sizeof(Posting)] = {};
+        if (fwrite(zeros, sizeof(Posting) - torn, 1, _file) != 1){
+            close();
+            return false;
+        }
+        records++;
+    }
+    // Diario de uma sessao anterior: a numeracao continua e um Reset marca
+    // que os saldos desta sessao comecam do zero.
+    _seq = records;
+    if (records > 0) post(0, Reset, 0);
+    return true;
+}
+
+void FirmBook::close(void)
+{
+    if (_file != nullptr){
+        flush();
+        fclose(_file);
+        _file = nullptr;
+    }
+}
+
+// Grava o grupo pendente com um unico fwrite. Sem arquivo aberto o livro so
+// conta os lancamentos.
+bool FirmBook::flush(void)
+{
+    if (_buffer.empty()) return true;
+    bool ok = true;
+    if (_file != nullptr){
+        ok = fwrite(_buffer.data(), sizeof(Posting), _buffer.size(), _file) == _buffer.size();
+        ok = (fflush(_file) == 0) && ok;
+    }
+    _groups++;
+    _buffer.clear();
+    return ok;
+}
+
+bool FirmBook::replay(const std::string& path, std::vector<int64_t>& balances)
+{
+    balances.clear();
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+    BookHeader h;
+    if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, bookmagic, 8) != 0
+        || h.version != bookversion || h.recordsize != sizeof(Posting)){
+        fclose(f);
+        return false;
+    }
+
+    std::vector<Posting> chunk(groupsize);
+    size_t n;
+    while ((n = fread(chunk.data(), sizeof(Posting), chunk.size(), f)) > 0){
+        for (size_t i = 0; i < n; i++){
+            const Posting& p = chunk[i];
+            if (p.kind == Reset){
+                balances.clear();
+                continue;
+            }
+            if (p.company >= balances.size()) balances.resize(p.company + 1, 0);
+            switch (p.kind){
+            case Add: balances[p.company] += p.amount; break;
+            case Sub: balances[p.company] -= p.amount; break;
+            case Set: balances[p.company] = p.amount; break;
+            default: break;
+            }
+        }
+    }
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+using namespace std;
+
+// Livro-caixa (FirmBook) do mundo: diario binario so de acrescimo com todo
+// lancamento de caixa das companies. Os lancamentos ficam num buffer em
+// memoria e sao gravados em grupo (group commit) quando o buffer enche ou
+// em flush(). Nao e thread-safe: os lancamentos vem da thread do Manager.
+//
+// Arquivo: "FIRMBOOK" + uint32 versao + uint32 tamanho do registro, seguido
+// de registros Posting de tamanho fixo.
+class FirmBook {
+    public:
+        enum Kind : uint32_t { Add = 1, Sub = 2, Set = 3, Reset = 4 };
+
+        struct Posting {
+            uint64_t seq;
+            int64_t amount;   // centavos (Money)
+            uint32_t company; // indice em Manager::companieslist
+            uint32_t kind;
+        };
+
+        static const size_t groupsize = 4096; // lancamentos por gravacao
+
+        FirmBook(void);
+        ~FirmBook(void);
+        FirmBook(const FirmBook&) = delete;
+        FirmBook& operator=(const FirmBook&) = delete;
+
+        // Acrescenta ao diario existente (mesma versao), depois de um Reset:
+        // o replay so ve os saldos da sessao nova.
+        bool open(const std::string& path);
+        void close(void);
+        bool isopen(void) const { return _file != nullptr; }
+
+        void post(uint32_t company, Kind kind, int64_t amount){
+            _buffer.push_back(Posting{_seq++, amount, company, kind});
+            if (_buffer.size() >= groupsize) flush();
+        }
+        bool flush(void);
+
+        uint64_t postings(void) const { return _seq; }
+        uint64_t groups(void) const { return _groups; }
+
+        // Refaz os saldos lendo o diario do inicio. Retorna false se o
+        // arquivo nao for um diario valido; um registro final incompleto
+        // (gravacao interrompida) e ignorado.
+        static bool replay(const std::string& path, std::vector<int64_t>& balances);
+
+    private:
+        FILE* _file;
+        std::vector<Posting> _buffer;
+        uint64_t _seq;
+        uint64_t _groups;
+};
@@ -0,0 +1,39 @@
+#include "fork.hpp"
+
+WorldFork::WorldFork(const TurnEngine& engine, const CashBook& cash, uint64_t seed)
+    : _engine(engine), _cash(cash), _seed(seed)
+{
+}
+
+size_t WorldFork::addBuilding(int type, uint32_t company)
+{
+    return _engine.addBuilding(type, (int)company);
+}
+
+// Mesmo turno do Manager::passarturno, so producao e contabilidade.
+void WorldFork::run(int turns, ThreadPool* pool)
+{
+    size_t n = _cash.size();
+    _turncash.resize(n);
+    for (int t = 0; t < turns; t++){
+        _engine.run(n, pool);
+        for (size_t i = 0; i < n; i++) _turncash[i] = Money::units(_engine.cashdelta(i)).cents;
+        _cash.apply(_turncash.data(), n);
+    }
+}
+
+// Cada fork tem suas colunas; pedacos ainda compartilhados sao so lidos,
+// e quem escreve copia antes (cow.hpp), entao os forks nao se enxergam.
+void WorldFork::runall(std::vector<WorldFork>& forks, int turns, ThreadPool& pool)
+{
+    pool.parallelFor(forks.size(), 1, [&forks, turns](size_t begin, size_t end, size_t){
+        for (size_t i = begin; i < end; i++) forks[i].run(turns);
+    });
+}
+
+uint64_t WorldFork::copiedchunks(void) const
+{
+    const BuildingColumns& c = _engine.columns();
+    return c.production.copies() + c.demand.copies() + c.stock.copies() + c.price.copies()
+         + c.cost.copies() + c.owner.copies() + c.income.copies() + _cash.balances().copies();
+}
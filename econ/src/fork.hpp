@@ -0,0 +1,47 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "turnengine.hpp"
+#include "cashbook.hpp"
+#include "rng.hpp"
+
+using namespace std;
+
+// Copia do mundo para perguntas "e se" (Manager::fork()). Criar o fork
+// custa O(1): as colunas dos buildings e o caixa das companies sao
+// copy-on-write, entao o fork so copia os pedacos que ele escreve e o mundo
+// original segue rodando sem esperar. Jogar o fork fora so solta as
+// referencias.
+//
+// O fork roda producao e contabilidade (TurnEngine + CashBook). Mercado,
+// estoques e objetos Building/Company nao vao junto: um building novo no
+// fork e so um slot nas colunas. Sem diario, nada vai para o FirmBook.
+class WorldFork {
+    private:
+        TurnEngine _engine;
+        CashBook _cash;
+        std::vector<int64_t> _turncash;
+        uint64_t _seed;
+
+    public:
+        WorldFork(const TurnEngine& engine, const CashBook& cash, uint64_t seed);
+
+        size_t addBuilding(int type, uint32_t company); // slot do building novo
+        void removeBuilding(size_t slot) { _engine.removeBuilding(slot); }
+        Money pay(uint32_t company, Money value) { return _cash.sub(company, value); }
+        void set(BuildingField field, size_t slot, int32_t value) { _engine.set(field, slot, value); }
+        const BuildingColumns& columns(void) const { return _engine.columns(); }
+
+        void run(int turns, ThreadPool* pool = nullptr);
+        // Um fork por worker do pool, cada um rodando sozinho seus turnos.
+        static void runall(std::vector<WorldFork>& forks, int turns, ThreadPool& pool);
+
+        Money cash(uint32_t company) const { return _cash.balance(company); }
+        size_t ncompanies(void) const { return _cash.size(); }
+        size_t nbuildings(void) const { return _engine.size(); }
+        uint64_t turn(void) const { return _engine.turn(); }
+        RandomStream random(uint64_t entity, RngPurpose purpose) const { return RandomStream(_seed, _engine.turn(), entity, purpose); }
+        // Pedacos de coluna copiados por escrita desde o fork.
+        uint64_t copiedchunks(void) const;
+};
@@ -0,0 +1,92 @@
+#include <cstring>
+#include <stdexcept>
+#include "intern.hpp"
+
+std::atomic<std::string_view*> Interner::_blocks[Interner::maxblocks];
+std::mutex Interner::_lock;
+std::unordered_map<std::string_view, Symbol> Interner::_lookup;
+std::vector<char*> Interner::_chunks;
+char* Interner::_free = nullptr;
+size_t Interner::_left = 0;
+std::atomic<uint32_t> Interner::_count(0);
+size_t Interner::_bytes = 0;
+uint32_t Interner::_worlds = 0;
+
+// Copia o texto para a arena. Nomes maiores que um pedaco ganham pedaco
+// proprio.
+const char* Interner::store(std::string_view text)
+{
+    if (text.size() > _left){
+        size_t size = text.size() > chunksize ? text.size() : chunksize;
+        _chunks.push_back(new char[size]);
+        _free = _chunks.back();
+        _left = size;
+    }
+    char* p = _free;
+    memcpy(p, text.data(), text.size());
+    _free += text.size();
+    _left -= text.size();
+    _bytes += text.size();
+    return p;
+}
+
+Symbol Interner::intern(std::string_view text)
+{
+    if (text.empty()) return 0;
+    std::lock_guard<std::mutex> guard(_lock);
+    auto it = _lookup.find(text);
+    if (it != _lookup.end()) return it->second;
+
+    uint32_t n = _count.load(std::memory_order_relaxed);
+    if (n == 0){
+        // Symbol 0 (nome vazio) ocupa a primeira entrada do bloco 0.
+        _blocks[0].store(new std::string_view[blocksize](), std::memory_order_release);
+        n = 1;
+    }
+    if (n == UINT32_MAX) throw std::length_error("Interner: acabaram os Symbols");
+    if ((n & (blocksize - 1)) == 0){
+        _blocks[n >> blockbits].store(new std::string_view[blocksize](), std::memory_order_release);
+    }
+    std::string_view stored(store(text), text.size());
+    _blocks[n >> blockbits].load(std::memory_order_relaxed)[n & (blocksize - 1)] = stored;
+    _lookup.emplace(stored, n);
+    _count.store(n + 1, std::memory_order_release);
+    return n;
+}
+
+size_t Interner::bytes(void)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _bytes;
+}
+
+void Interner::retain(void)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _worlds++;
+}
+
+void Interner::release(void)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_worlds > 0) _worlds--;
+}
+
+// Devolve a arena e a tabela de uma vez, como o pool de um mundo.
+bool Interner::clear(void)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_worlds > 1) return false;
+    for (char* chunk : _chunks) delete[] chunk;
+    _chunks.clear();
+    _free = nullptr;
+    _left = 0;
+    _bytes = 0;
+    _lookup.clear();
+    uint32_t n = _count.load(std::memory_order_relaxed);
+    for (uint32_t b = 0; b < maxblocks && ((uint64_t)b << blockbits) < n; b++){
+        delete[] _blocks[b].exchange(nullptr, std::memory_order_acq_rel);
+    }
+    _count.store(0, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <iostream>
+#include <string_view>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+using namespace std;
+
+// Nome internado: indice na tabela de nomes do mundo. 0 e o nome vazio.
+typedef uint32_t Symbol;
+
+// Tabela de nomes unica do programa. Cada texto distinto e guardado uma
+// vez numa arena que nunca move; Building e Company guardam so o Symbol
+// (4 bytes) e devolvem string_view, entao listar nao aloca.
+//
+// intern() pega um lock (so aloca quando o nome e novo); str() nao pega
+// lock: os blocos da tabela sao publicados com release e nunca mudam de
+// lugar. A tabela cresce bloco a bloco ate o fim do espaco de Symbol; se
+// ele acabar, intern() lanca length_error em vez de devolver o nome vazio.
+//
+// A tabela e do programa, nao do mundo: cada Manager se registra com
+// retain()/release() e Manager::reset() chama clear(), que so libera tudo
+// quando ele e o unico mundo vivo (com outros, os nomes ficam). Depois de
+// clear() nenhum Symbol antigo vale, e ninguem pode estar lendo str().
+class Interner {
+    private:
+        static const uint32_t blockbits = 16;
+        static const uint32_t blocksize = 1u << blockbits; // symbols por bloco
+        static const uint32_t maxblocks = 1u << (32 - blockbits); // todo Symbol de 32 bits
+        static const size_t chunksize = 64 * 1024;         // bytes por pedaco da arena
+
+        static std::atomic<std::string_view*> _blocks[maxblocks];
+        static std::mutex _lock;
+        static std::unordered_map<std::string_view, Symbol> _lookup;
+        static std::vector<char*> _chunks;
+        static char* _free;   // proximo byte livre no pedaco atual
+        static size_t _left;  // bytes livres no pedaco atual
+        static std::atomic<uint32_t> _count;
+        static size_t _bytes;
+        static uint32_t _worlds;
+
+        static const char* store(std::string_view text);
+
+    public:
+        static Symbol intern(std::string_view text);
+        static std::string_view str(Symbol s) {
+            if (s == 0) return std::string_view();
+            return _blocks[s >> blockbits].load(std::memory_order_acquire)[s & (blocksize - 1)];
+        }
+        static size_t size(void) { return _count.load(std::memory_order_relaxed); }
+        static size_t bytes(void); // texto guardado na arena
+
+        static void retain(void);  // um mundo a mais usando a tabela
+        static void release(void);
+        static bool clear(void);   // libera tudo se houver no maximo um mundo
+};
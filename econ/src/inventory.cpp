@@ -0,0 +1,176 @@
+#include <algorithm>
+#include "inventory.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ECON_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Mesmas operacoes, na mesma ordem, que a versao AVX2: multiplicacoes e
+    // somas separadas (sem FMA) para o resultado ser identico bit a bit.
+    void ageScalar(size_t n, float decay, float keep, float* quantity, float* quality,
+                   float* age, const float* cost, float* charge)
+    {
+        for (size_t i = 0; i < n; i++){
+            float q = quantity[i] * keep;
+            quantity[i] = q;
+            quality[i] = quality[i] * decay;
+            age[i] = age[i] + 1.0f;
+            charge[i] = q * cost[i];
+        }
+    }
+
+#ifdef ECON_HAVE_AVX2_KERNEL
+    __attribute__((target("avx2")))
+    void ageAvx2(size_t n, float decay, float keep, float* quantity, float* quality,
+                 float* age, const float* cost, float* charge)
+    {
+        const __m256 vdecay = _mm256_set1_ps(decay);
+        const __m256 vkeep = _mm256_set1_ps(keep);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8){
+            __m256 q = _mm256_mul_ps(_mm256_loadu_ps(quantity + i), vkeep);
+            _mm256_storeu_ps(quantity + i, q);
+            _mm256_storeu_ps(quality + i, _mm256_mul_ps(_mm256_loadu_ps(quality + i), vdecay));
+            _mm256_storeu_ps(age + i, _mm256_add_ps(_mm256_loadu_ps(age + i), one));
+            _mm256_storeu_ps(charge + i, _mm256_mul_ps(q, _mm256_loadu_ps(cost + i)));
+        }
+        ageScalar(n - i, decay, keep, quantity + i, quality + i, age + i, cost + i, charge + i);
+    }
+#endif
+
+    Inventory::AgeKernel pickKernel(void)
+    {
+        Inventory::AgeKernel k = Inventory::avx2Kernel();
+        return k != nullptr ? k : Inventory::scalarKernel();
+    }
+}
+
+Inventory::Inventory(void)
+{
+    _kernel = pickKernel();
+}
+
+Inventory::AgeKernel Inventory::scalarKernel(void)
+{
+    return &ageScalar;
+}
+
+Inventory::AgeKernel Inventory::avx2Kernel(void)
+{
+#ifdef ECON_HAVE_AVX2_KERNEL
+    if (__builtin_cpu_supports("avx2")) return &ageAvx2;
+#endif
+    return nullptr;
+}
+
+const char* Inventory::kernelName(void)
+{
+    return avx2Kernel() != nullptr ? "avx2" : "scalar";
+}
+
+void Inventory::grow(uint32_t product)
+{
+    if (product >= _columns.size()){
+        _columns.resize(product + 1);
+        _rules.resize(product + 1);
+    }
+}
+
+void Inventory::setRules(uint32_t product, const ProductRules& rules)
+{
+    grow(product);
+    _rules[product] = rules;
+}
+
+size_t Inventory::add(uint32_t product, uint32_t owner, Handle building, float quantity, float quality)
+{
+    grow(product);
+    Columns& c = _columns[product];
+    c.quantity.push_back(quantity);
+    c.quality.push_back(quality);
+    c.age.push_back(0.0f);
+    c.cost.push_back(_rules[product].storagecost);
+    c.charge.push_back(0.0f);
+    c.owner.push_back(owner);
+    c.building.push_back(building);
+    size_t i = c.quantity.size() - 1;
+    _entries[building].push_back(((uint64_t)product << 32) | i);
+    return i;
+}
+
+namespace {
+    template <typename V>
+    void swapRemove(V& column, size_t i){
+        column[i] = column.back();
+        column.pop_back();
+    }
+}
+
+// Tira todas as entradas de um building (demolicao): O(entradas dele), cada
+// uma trocada com a ultima do produto, que muda de indice na lista do seu
+// building. Do maior indice para o menor, a ultima nunca e uma entrada
+// deste building ainda por remover.
+size_t Inventory::removeBuilding(Handle building)
+{
+    auto it = _entries.find(building);
+    if (it == _entries.end()) return 0;
+    std::vector<uint64_t> mine;
+    mine.swap(it->second);
+    _entries.erase(it);
+    std::sort(mine.begin(), mine.end(), [](uint64_t a, uint64_t b){
+        return (uint32_t)a > (uint32_t)b;
+    });
+    for (uint64_t e : mine){
+        uint32_t product = (uint32_t)(e >> 32);
+        size_t i = (uint32_t)e;
+        Columns& c = _columns[product];
+        size_t last = c.building.size() - 1;
+        if (i != last){
+            std::vector<uint64_t>& moved = _entries[c.building[last]];
+            uint64_t from = ((uint64_t)product << 32) | last;
+            *std::find(moved.begin(), moved.end(), from) = ((uint64_t)product << 32) | i;
+        }
+        swapRemove(c.quantity, i);
+        swapRemove(c.quality, i);
+        swapRemove(c.age, i);
+        swapRemove(c.cost, i);
+        swapRemove(c.charge, i);
+        swapRemove(c.owner, i);
+        swapRemove(c.building, i);
+    }
+    return mine.size();
+}
+
+void Inventory::age(size_t ncompanies)
+{
+    _charges.assign(ncompanies, 0.0);
+    for (size_t p = 0; p < _columns.size(); p++){
+        Columns& c = _columns[p];
+        size_t n = c.quantity.size();
+        if (n == 0) continue;
+        _kernel(n, _rules[p].decay, _rules[p].keep, c.quantity.data(), c.quality.data(),
+                c.age.data(), c.cost.data(), c.charge.data());
+        // Soma por company em ordem fixa: mesmo resultado com qualquer kernel.
+        for (size_t i = 0; i < n; i++){
+            if (c.owner[i] < ncompanies) _charges[c.owner[i]] += c.charge[i];
+        }
+    }
+}
+
+void Inventory::clear(void)
+{
+    _columns.clear();
+    _rules.clear();
+    _charges.clear();
+    _entries.clear();
+}
+
+size_t Inventory::size(void) const
+{
+    size_t n = 0;
+    for (const Columns& c : _columns) n += c.quantity.size();
+    return n;
+}
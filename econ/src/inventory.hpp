@@ -0,0 +1,66 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "slotmap.hpp"
+
+using namespace std;
+
+// Estoques (StoredProduct do diagrama) guardados por produto em colunas
+// continuas. A cada turno cada entrada envelhece, perde qualidade e
+// quantidade e cobra custo de armazenagem da company dona.
+class Inventory {
+    public:
+        // Parametros do produto, iguais para todas as suas entradas.
+        struct ProductRules {
+            float decay = 0.99f;    // qualidade *= decay por turno
+            float keep = 0.995f;    // quantidade *= keep por turno
+            float storagecost = 0.01f; // custo padrao por unidade por turno
+        };
+
+        struct Columns {
+            std::vector<float> quantity;
+            std::vector<float> quality;
+            std::vector<float> age;      // turnos em estoque
+            std::vector<float> cost;     // custo de armazenagem por unidade
+            std::vector<float> charge;   // cobrado no ultimo turno
+            std::vector<uint32_t> owner; // indice da company
+            std::vector<Handle> building;
+        };
+
+        // Kernel de um turno sobre [0, n) de uma coluna. Existe uma versao
+        // escalar e uma AVX2; a escolha e feita uma vez, pela CPU.
+        typedef void (*AgeKernel)(size_t n, float decay, float keep,
+                                  float* quantity, float* quality, float* age,
+                                  const float* cost, float* charge);
+
+        Inventory(void);
+
+        void setRules(uint32_t product, const ProductRules& rules);
+        size_t add(uint32_t product, uint32_t owner, Handle building, float quantity, float quality = 1.0f);
+        size_t removeBuilding(Handle building);
+        void age(size_t ncompanies); // um turno para todos os produtos
+        void clear(void);
+
+        size_t products(void) const { return _columns.size(); }
+        size_t size(void) const;
+        const Columns& columns(uint32_t product) const { return _columns[product]; }
+        double chargeOf(size_t company) const { return company < _charges.size() ? _charges[company] : 0.0; }
+
+        static AgeKernel scalarKernel(void);
+        static AgeKernel avx2Kernel(void); // nullptr se a CPU nao tiver AVX2
+        static const char* kernelName(void);
+        void setKernel(AgeKernel kernel) { _kernel = kernel; }
+
+    private:
+        std::vector<Columns> _columns;
+        std::vector<ProductRules> _rules;
+        std::vector<double> _charges; // custo de armazenagem por company no turno
+        // Onde estao as entradas de cada building: (produto << 32) | indice.
+        // Demolir olha so estas, nao todas as colunas.
+        std::unordered_map<Handle, std::vector<uint64_t>> _entries;
+        AgeKernel _kernel;
+
+        void grow(uint32_t product);
+};
@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include "log.hpp"
+
+namespace {
+    const char* levelnames[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+}
+
+Logger& Logger::instance(void)
+{
+    static Logger logger;
+    return logger;
+}
+
+// Anel limitado no estilo de Vyukov: cada slot guarda o numero de sequencia
+// que diz se esta livre para o produtor ou pronto para a thread de fundo.
+Logger::Logger(void)
+{
+    _ring = new Slot[slots];
+    for (size_t i = 0; i < slots; i++) _ring[i].seq.store(i, std::memory_order_relaxed);
+    _head = 0;
+    _tail = 0;
+    _written = 0;
+    _dropped = 0;
+    _stop = false;
+    _thread = std::thread(&Logger::loop, this);
+}
+
+Logger::~Logger(void)
+{
+    _stop = true;
+    _thread.join();
+    drain();
+    fflush(stdout);
+    delete[] _ring;
+}
+
+void Logger::push(int level, const std::string& msg)
+{
+    uint64_t pos = _head.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true){
+        slot = &_ring[pos % slots];
+        uint64_t seq = slot->seq.load(std::memory_order_acquire);
+        int64_t diff = (int64_t)seq - (int64_t)pos;
+        if (diff == 0){
+            if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0){
+            _dropped.fetch_add(1, std::memory_order_relaxed); // anel cheio
+            return;
+        } else {
+            pos = _head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->len = (uint32_t)std::min(msg.size(), msgsize);
+    slot->level = level;
+    memcpy(slot->text, msg.data(), slot->len);
+    slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+// Grava tudo que estiver pronto; retorna false se nao havia nada.
+bool Logger::drain(void)
+{
+    bool any = false;
+    while (true){
+        Slot& slot = _ring[_tail % slots];
+        if (slot.seq.load(std::memory_order_acquire) != _tail + 1) break;
+        const char* name = (slot.level >= 0 && slot.level <= ECON_LOG_ERROR) ? levelnames[slot.level] : "?";
+        fprintf(stdout, "[%s] %.*s\n", name, (int)slot.len, slot.text);
+        slot.seq.store(_tail + slots, std::memory_order_release);
+        _tail++;
+        any = true;
+    }
+    if (any){
+        fflush(stdout);
+        _written.store(_tail, std::memory_order_release);
+    }
+    return any;
+}
+
+void Logger::loop(void)
+{
+    while (!_stop.load(std::memory_order_acquire)){
+        if (!drain()){
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+void Logger::flush(void)
+{
+    uint64_t target = _head.load(std::memory_order_acquire);
+    while (_written.load(std::memory_order_acquire) < target){
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
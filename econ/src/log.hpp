@@ -0,0 +1,74 @@
+#pragma once
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+using namespace std;
+
+// Niveis de log. Tudo abaixo de ECON_LOG_LEVEL e removido na compilacao:
+// compile com -DECON_LOG_LEVEL=0 para ver as mensagens de debug dos
+// construtores.
+#define ECON_LOG_DEBUG 0
+#define ECON_LOG_INFO  1
+#define ECON_LOG_WARN  2
+#define ECON_LOG_ERROR 3
+#define ECON_LOG_OFF   4
+
+#ifndef ECON_LOG_LEVEL
+#define ECON_LOG_LEVEL ECON_LOG_INFO
+#endif
+
+// Uso: ELOG(ECON_LOG_DEBUG, "building (" << this << ") constructed!");
+// A condicao e constante, entao com o nivel desligado nem os argumentos
+// sao avaliados.
+#define ELOG(level, msg) \
+    do { \
+        if ((level) >= ECON_LOG_LEVEL) { \
+            std::ostringstream _elog; \
+            _elog << msg; \
+            Logger::instance().push((level), _elog.str()); \
+        } \
+    } while (0)
+
+#define ELOG_DEBUG(msg) ELOG(ECON_LOG_DEBUG, msg)
+#define ELOG_INFO(msg)  ELOG(ECON_LOG_INFO, msg)
+#define ELOG_WARN(msg)  ELOG(ECON_LOG_WARN, msg)
+#define ELOG_ERROR(msg) ELOG(ECON_LOG_ERROR, msg)
+
+// Saida assincrona: quem loga so copia a mensagem para um anel de tamanho
+// fixo (sem lock, varios produtores) e uma thread de fundo grava no stdout.
+// Com o anel cheio a mensagem e descartada e contada, nunca bloqueia.
+class Logger {
+    public:
+        static constexpr size_t slots = 4096;
+        static constexpr size_t msgsize = 248;
+
+        static Logger& instance(void);
+        void push(int level, const std::string& msg);
+        void flush(void);           // espera o anel esvaziar
+        uint64_t dropped(void) const { return _dropped.load(); }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> seq;
+            uint32_t len;
+            int32_t level;
+            char text[msgsize];
+        };
+
+        Slot* _ring;
+        std::atomic<uint64_t> _head;  // proxima posicao dos produtores
+        uint64_t _tail;               // proxima posicao da thread de fundo
+        std::atomic<uint64_t> _written;
+        std::atomic<uint64_t> _dropped;
+        std::atomic<bool> _stop;
+        std::thread _thread;
+
+        Logger(void);
+        ~Logger(void);
+        void loop(void);
+        bool drain(void);
+};
@@ -10,9 +10,16 @@
 using namespace std;
 #include "buildings.hpp"
 #include "manager.hpp"
+#include "script.hpp"
+#include <cstdio>
+#include <cstring>
 
 
-int main() 
+// econ                    menu interativo
+// econ --script arquivo   executa os comandos do arquivo sem menu
+// econ --script -         le os comandos do stdin
+// econ --journal arquivo  grava o FirmBook no arquivo (por padrao sem livro-caixa)
+int main(int argc, char* argv[])
 {
 // 	int objsize,objposx,objposy;
 //  string fname,lname, objname;
@@ -26,9 +33,36 @@ int main()
 //     cin>>objsize;
 // 	Building buildingObj1 (objposx,objposy,objsize,objname);
 //     Building building2 (1,2,3,"predio 2");
+    const char* scriptpath = nullptr;
+    const char* journalpath = nullptr;
+    for (int i = 1; i < argc; i++){
+        if (i + 1 < argc && strcmp(argv[i], "--script") == 0) scriptpath = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--journal") == 0) journalpath = argv[++i];
+        else {
+            fprintf(stderr, "uso: econ [--script arquivo|-] [--journal arquivo]\n");
+            return 1;
+        }
+    }
+
     Manager runner;
-    while (1){
-        runner.esperaAcao();
+    if (journalpath != nullptr && !runner.abrirlivro(journalpath)){
+        fprintf(stderr, "journal: cannot open %s\n", journalpath);
+        return 1;
+    }
+    if (scriptpath != nullptr){
+        std::ios::sync_with_stdio(false);
+        FILE* input = strcmp(scriptpath, "-") == 0 ? stdin : fopen(scriptpath, "rb");
+        if (input == nullptr){
+            fprintf(stderr, "script: cannot open %s\n", scriptpath);
+            return 1;
+        }
+        ScriptRunner script(runner);
+        bool ok = script.run(input);
+        if (input != stdin) fclose(input);
+        script.report();
+        return ok ? 0 : 1;
+    }
+    while (runner.esperaAcao()){
     }
     return 0;
 }
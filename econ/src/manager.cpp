@@ -1,34 +1,78 @@
 #include <iostream>
+#include <cmath>
 #include "manager.hpp"
+#include "snapshot.hpp"
+#include "profiler.hpp"
+
+namespace {
+    const char* worldfile = "world.bin";
+}
 
 Manager::Manager(void)
 {
      selectedCompany=0;
+     _chosencompany=-1;
+     _seed=0;
+     _cashbook.attachjournal(&_book);
+     Interner::retain();
+}
+
+Manager::~Manager(void)
+{
+    Interner::release();
 }
 
-void Manager::esperaAcao(){
+// Retorna false quando o usuario escolhe sair.
+bool Manager::esperaAcao(){
     int escolha;
-    cout<<"\n Chose action: \n 0 - EXIT     - NOT WORKING RN - PRESS CTRL+C INSTEAD!!! \n 1 - Create Building \n 2 - List Buildings \n 7 - List companies  \n 8 - Create Company \n 9 - Select Company \n ";
+    cout<<"\n Chose action: \n 0 - Save and Exit \n 1 - Create Building \n 2 - List Buildings \n 3 - Pass Turn \n 4 - Reset World \n 5 - Demolish Building \n 6 - Save World \n 7 - List companies  \n 8 - Create Company \n 9 - Select Company \n 10 - Load World \n 11 - Check FirmBook \n ";
     cin>>escolha;
     switch(escolha){
     case(0):
+        salvar(worldfile);
         cout<<"Saindo!";
-        exit;
-        break;
+        return false;
     case(1):
     {
-        int tipo;
+        int tipo,x,y;
         std::string nome;
         cout<<"Enter building name: ";
         cin>>nome;
         cout<<"Enter 1 for producer, 2 for consumer or 3 for both:";
         cin>>tipo;
-        this->criabuilding(tipo,nome);
+        cout<<"Enter building posx: ";
+        cin>>x;
+        cout<<"Enter building posy: ";
+        cin>>y;
+        this->criabuilding(tipo,nome,x,y);
         break;
     }
     case (2):
     {
-        selectedCompany->listBuildings();
+        listBuildings();
+        break;
+    }
+    case (3):
+    {
+        passarturno();
+        break;
+    }
+    case (4):
+    {
+        reset();
+        break;
+    }
+    case (5):
+    {
+        size_t i;
+        cout << "Enter building index (see List Buildings): ";
+        cin >> i;
+        if (!demolirbuilding(i)) cout << "Building not demolished.\n";
+        break;
+    }
+    case (6):
+    {
+        if (!salvar(worldfile)) cout << "World not saved.\n";
         break;
     }
     case (7):
@@ -55,35 +99,126 @@ void Manager::esperaAcao(){
         selectCompany(i);
         break;
     }
+    case (10):
+    {
+        if (!carregar(worldfile)) cout << "World not loaded.\n";
+        break;
+    }
+    case (11):
+    {
+        conferirlivro();
+        break;
+    }
     default:
         cout<<"\n Escolha não reconhecida \n ";
         break;
     }
-
+    return true;
 };
 
 
-void Manager::criabuilding(int tipo, std::string objnome)
+Handle Manager::criabuilding(int tipo, std::string_view objnome, int x, int y)
 {
     if (selectedCompany == nullptr){
         cout << "Building not created, please Choose a Valid Company.";
+        return NullHandle;
     }
-    else {
-    Building* tmp = selectedCompany->criabuilding(tipo, objnome);
-    allbuildingslist[tmp->uniqueID()] = tmp;
-    }
+    materializar();
+    Building* tmp = selectedCompany->criabuilding(_buildings, tipo, objnome, x, y);
+    tmp->attach(&_engine, _engine.addBuilding(tipo, _chosencompany));
+    _spatial.insert(tmp->handle(), x, y, tipo);
+    return tmp->handle();
 };
 
+// Demole o building de indice "index" da company selecionada. O estoque
+// restante e vendido pelo preco do building antes da demolicao.
+bool Manager::demolirbuilding(size_t index)
+{
+    materializar();
+    if (selectedCompany == nullptr || index >= selectedCompany->buildings().size()){
+        return false;
+    }
+    Handle h = selectedCompany->buildings()[index];
+    Building* building = *_buildings.get(h);
+    size_t slot = _buildings.denseIndex(h);
+    selectedCompany->addcash(Money::units((int64_t)_engine.stockAt(slot) * _engine.columns().price[slot]));
+
+    _spatial.remove(h, building->posx(), building->posy());
+    _inventory.removeBuilding(h);
+    selectedCompany->demolebuilding(_buildings, building);
+    _engine.removeBuilding(slot);
+    if (slot < _buildings.size()){
+        _buildings.at(slot)->attach(&_engine, slot); // o ultimo veio para ca
+    }
+    return true;
+}
+
 Company* Manager::getcompany(int id){
+    materializar(); // quem pega a company pode ler buildings()
     return companieslist[id];
 }
 
 void Manager::selectCompany(int index){
     selectedCompany = companieslist.at(index);
+    _chosencompany = index;
     cout << "Selected " << selectedCompany->getName() << "\n";
     cout << "Selected Company Member = " << selectedCompany;
 }
 
+Building* Manager::getbuilding(Handle h){
+    materializar();
+    Building** b = _buildings.get(h);
+    return b == nullptr ? nullptr : *b;
+}
+
+// Consultas por posicao, respondidas pela grade (SpatialIndex) sem varrer
+// todos os buildings. typemask: bit 1 << tipo (0 aceita todos).
+void Manager::buildingsnear(int x, int y, int radius, std::vector<SpatialIndex::Entry>& out, uint32_t typemask){
+    materializar();
+    _spatial.within(x, y, radius, out, typemask);
+}
+
+Handle Manager::nearestbuilding(int x, int y, uint32_t typemask){
+    materializar();
+    return _spatial.nearest(x, y, typemask);
+}
+
+// Ordens de compra e venda da company selecionada; executam no proximo
+// passarturno, ao preco de equilibrio do produto.
+bool Manager::buy(uint32_t product, int price, int qty){
+    if (selectedCompany == nullptr || product >= maxproducts) return false;
+    return _market.bid(product, (uint32_t)_chosencompany, price, qty);
+}
+
+bool Manager::sell(uint32_t product, int price, int qty){
+    if (selectedCompany == nullptr || product >= maxproducts) return false;
+    return _market.ask(product, (uint32_t)_chosencompany, price, qty);
+}
+
+// So le: book() marcaria o livro para o proximo clear().
+OrderBook::Result Manager::marketresult(uint32_t product) const {
+    const OrderBook* b = _market.find(product);
+    return b != nullptr ? b->last() : OrderBook::Result{-1, 0};
+}
+
+// Coloca estoque de um produto no building de indice "index" da company
+// selecionada. O estoque envelhece e cobra armazenagem a cada turno.
+bool Manager::estocar(size_t index, uint32_t product, float qty){
+    materializar();
+    if (selectedCompany == nullptr || index >= selectedCompany->buildings().size() || product >= maxproducts || !(qty > 0)){
+        return false;
+    }
+    _inventory.add(product, (uint32_t)_chosencompany, selectedCompany->buildings()[index], qty);
+    return true;
+}
+
+bool Manager::listBuildings(){
+    if (selectedCompany == nullptr) return false;
+    materializar();
+    selectedCompany->listBuildings(_buildings);
+    return true;
+}
+
 void Manager::listCompanies(){
  int i=0;
  cout << "INDEX             COMPANY NAME            MONEY \n";
@@ -95,17 +230,193 @@ void Manager::listCompanies(){
     }
 };
 
-size_t Manager::criarCompany(std::string nome)
+size_t Manager::criarCompany(std::string_view nome)
 {
-    Company * tmp = new Company(nome,1000);
+    Company * tmp = _companypool.create(nome, Money::units(1000));
+    tmp->attachbook(&_cashbook);
     companieslist.push_back(tmp);
     size_t len = companieslist.size();
     return len-1;
 }
 
+// Fases do turno, cada uma com seu cronometro (ver profiler.hpp).
 void Manager::passarturno(){
+    PROFILE_SCOPE("turn");
+    Profiler::setTurn(_engine.turn() + 1);
+    {
+        PROFILE_SCOPE("costs");
+        size_t touched = _recipes.update(); // so os custos cujas entradas mudaram
+        PROFILE_COUNTER("products_touched", (int64_t)touched);
+        (void)touched;
+    }
+    {
+        PROFILE_SCOPE("production");
+        _engine.run(companieslist.size(), &_pool);
+        PROFILE_COUNTER("buildings", (int64_t)_engine.size());
+        PROFILE_COUNTER("buildings_touched", (int64_t)_engine.touched());
+        PROFILE_COUNTER("companies_touched", (int64_t)_engine.companiestouched());
+    }
+    {
+        PROFILE_SCOPE("market");
+        _market.clear(companieslist.size(), &_pool);
+        PROFILE_COUNTER("markets_touched", (int64_t)_market.touched());
+    }
+    {
+        PROFILE_SCOPE("storage");
+        _inventory.age(companieslist.size());
+    }
+    {
+        PROFILE_SCOPE("accounting");
+        // Todas as contas num lancamento so; armazenagem arredonda ao centavo.
+        size_t n = companieslist.size();
+        _turncash.resize(n);
+        for (size_t i = 0; i < n; i++){
+            Money result = Money::units(_engine.cashdelta(i) + _market.cashdelta(i)) - Money::fromDouble(_inventory.chargeOf(i));
+            _turncash[i] = result.cents;
+        }
+        size_t saturated = _cashbook.apply(_turncash.data(), n);
+        PROFILE_COUNTER("saturated", (int64_t)saturated);
+        (void)saturated;
+        _market.reset();
+        _book.flush(); // um grupo por turno
+        PROFILE_COUNTER("postings", (int64_t)_book.postings());
+    }
+    cout << "Turn " << _engine.turn() << " done (recomputed " << _engine.touched() << " buildings, "
+         << _engine.companiestouched() << " companies, " << _market.touched() << " markets).\n";
 };
 
+// Libera o mundo inteiro de uma vez: cada Company leva junto o pool dos
+// seus buildings.
+void Manager::reset(){
+    _pending.reset();
+    _buildings.clear();
+    companieslist.clear();
+    selectedCompany = nullptr;
+    _chosencompany = -1;
+    _engine.clear();
+    _spatial.clear();
+    _market = Market(); // reset() so descartaria as ordens, nao o last() dos livros
+    _recipes = RecipeBook();
+    _inventory.clear();
+    _companypool.clear();
+    _cashbook.clear();
+    Interner::clear(); // nomes vao junto com o mundo (se for o unico)
+    _book.post(0, FirmBook::Reset, 0);
+    cout << "World reset.\n";
+};
+
+
 
 
 
+// Grava companies, buildings e as colunas do TurnEngine num snapshot
+// binario (ver snapshot.hpp).
+bool Manager::salvar(const std::string& path){
+    materializar();
+    SnapshotWriter writer;
+    for (Company* company : companieslist){
+        writer.addCompany(company->getName(), company->getcash().cents);
+    }
+    for (Building* building : _buildings){
+        writer.addBuilding(building->uniqueID(), building->type(), building->posx(), building->posy(), building->nome());
+    }
+    _engine.sync(); // estoque dos buildings estaveis em dia
+    const BuildingColumns& cols = _engine.columns();
+    writer.setColumn(ColProduction, &cols.production);
+    writer.setColumn(ColDemand, &cols.demand);
+    writer.setColumn(ColStock, &cols.stock);
+    writer.setColumn(ColPrice, &cols.price);
+    writer.setColumn(ColCost, &cols.cost);
+    writer.setColumn(ColOwner, &cols.owner);
+    if (!writer.write(path, _engine.turn(), _seed)) return false;
+    cout << "World saved to " << path << "\n";
+    return true;
+};
+
+// Substitui o mundo atual pelo snapshot, usando o mapeamento no lugar: as
+// colunas do TurnEngine apontam para as paginas do arquivo (privadas, um
+// pedaco so e copiado quando alguem escreve nele) e os Buildings (pool,
+// registro, indice espacial, nomes) so sao criados quando algo precisa
+// deles, em materializar(). Carregar e passar turnos nao pagam O(buildings)
+// de objetos; o tempo real esta no snapshotbench.
+bool Manager::carregar(const std::string& path){
+    std::shared_ptr<SnapshotFile> file = std::make_shared<SnapshotFile>();
+    if (!file->open(path)) return false;
+    const SnapshotHeader& h = file->header();
+    const int32_t* owner = file->column(ColOwner);
+    for (uint64_t i = 0; i < h.nbuildings; i++){
+        if (owner[i] < 0 || (uint64_t)owner[i] >= h.ncompanies) return false;
+    }
+
+    reset();
+    _seed = h.seed;
+    const SnapshotCompany* companies = file->companies();
+    for (uint64_t c = 0; c < h.ncompanies; c++){
+        Company* company = _companypool.create(file->name(companies[c].nameoffset, companies[c].namelen), Money::fromCents(companies[c].cash));
+        company->attachbook(&_cashbook);
+        companieslist.push_back(company);
+    }
+
+    _engine.restore(file, h.nbuildings, file->writecolumn(ColProduction), file->writecolumn(ColDemand),
+                    file->writecolumn(ColStock), file->writecolumn(ColPrice), file->writecolumn(ColCost),
+                    file->writecolumn(ColOwner), h.turn);
+    if (h.nbuildings > 0) _pending = file;
+    if (!companieslist.empty()) selectCompany(0);
+    cout << "World loaded from " << path << "\n";
+    return true;
+};
+
+// Cria os Buildings do snapshot carregado, na ordem dos slots do
+// TurnEngine. Nada entra ou sai do mundo antes disto (criar e demolir
+// chamam aqui), entao o slot i ainda e o building i do arquivo; o dono vem
+// da coluna, que pode ter mudado desde o carregar.
+void Manager::materializar(){
+    if (!_pending) return;
+    std::shared_ptr<SnapshotFile> file;
+    file.swap(_pending);
+    const SnapshotBuilding* buildings = file->buildings();
+    const Column& owner = _engine.columns().owner;
+    uint64_t n = file->header().nbuildings;
+    uint64_t maxid = 0;
+    for (uint64_t i = 0; i < n; i++){
+        const SnapshotBuilding& b = buildings[i];
+        Building* tmp = companieslist[owner[i]]->criabuilding(_buildings, b.type,
+            file->name(b.nameoffset, b.namelen), b.x, b.y, b.uniqueID);
+        tmp->attach(&_engine, i);
+        _spatial.insert(tmp->handle(), b.x, b.y, b.type);
+        if (b.uniqueID > maxid) maxid = b.uniqueID;
+    }
+    IDGenerator::advance(maxid);
+}
+
+// Abre (ou continua) o diario do livro-caixa deste mundo. Companies que ja
+// existem entram com o saldo atual, para o replay bater com o caixa.
+bool Manager::abrirlivro(const std::string& path){
+    if (!_book.open(path)) return false;
+    _bookpath = path;
+    for (size_t i = 0; i < companieslist.size(); i++){
+        _book.post((uint32_t)i, FirmBook::Set, companieslist[i]->getcash().cents);
+    }
+    return true;
+};
+
+// Refaz os saldos a partir do diario e compara com o caixa atual.
+bool Manager::conferirlivro(){
+    if (_bookpath.empty()){
+        cout << "No FirmBook open.\n";
+        return false;
+    }
+    _book.flush();
+    std::vector<int64_t> balances;
+    if (!FirmBook::replay(_bookpath, balances)){
+        cout << "FirmBook could not be read.\n";
+        return false;
+    }
+    bool ok = balances.size() == companieslist.size();
+    for (size_t i = 0; ok && i < companieslist.size(); i++){
+        ok = balances[i] == companieslist[i]->getcash().cents;
+    }
+    cout << "FirmBook: " << _book.postings() << " postings, " << _book.groups()
+         << " groups, balances " << (ok ? "match" : "DO NOT match") << ".\n";
+    return ok;
+};
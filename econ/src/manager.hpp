@@ -1,9 +1,20 @@
 #pragma once
 #include <iostream>
 #include <vector>
-#include <map>
+#include <memory>
 #include "buildings.hpp"
 #include "company.hpp"
+#include "turnengine.hpp"
+#include "pool.hpp"
+#include "firmbook.hpp"
+#include "spatial.hpp"
+#include "market.hpp"
+#include "recipes.hpp"
+#include "inventory.hpp"
+#include "rng.hpp"
+#include "fork.hpp"
+
+class SnapshotFile;
 
     /*struct objeto{
         Building* ponteiro;
@@ -13,21 +24,72 @@
 class Manager{
 
     private:
+    ObjectPool<Company, 64> _companypool;
     std::vector<Company*> companieslist;
     int _chosencompany;
     Company* selectedCompany;
     // int _escolha;
-    std::map<int, Building*> allbuildingslist;
+    BuildingRegistry _buildings;
+    TurnEngine _engine;
+    ThreadPool _pool;
+    FirmBook _book;
+    CashBook _cashbook;             // caixa de todas as companies, diario em _book
+    std::vector<int64_t> _turncash; // resultado do turno por company, em centavos
+    SpatialIndex _spatial;
+    Market _market;
+    RecipeBook _recipes;
+    Inventory _inventory;
+    std::string _bookpath;
+    uint64_t _seed;                 // semente do mundo, chave de todo sorteio
     //Building* _bdptr;
-    size_t criarCompany(std::string nome);
-    void selectCompany(int index);
-    void criabuilding( int _type, std::string objnome);
+    // Snapshot carregado cujos Buildings ainda nao foram criados (ver
+    // materializar); nulo quando o registro ja esta em dia.
+    std::shared_ptr<SnapshotFile> _pending;
+    void materializar();
 
     public:
+    // Catalogo fixo: produtos validos sao 0 .. maxproducts-1. Mercado e
+    // estoque crescem por id de produto, entao id fora disso e recusado.
+    static constexpr uint32_t maxproducts = 1024;
+
     Manager(void);
-    void esperaAcao();
+    ~Manager(void);
+    size_t criarCompany(std::string_view nome);
+    void selectCompany(int index);
+    Handle criabuilding( int _type, std::string_view objnome, int x = 0, int y = 0);
+    bool demolirbuilding(size_t index);
+    bool esperaAcao();
     Company* getcompany(int id);
     void listCompanies();
+    bool listBuildings();
+    size_t ncompanies() { return companieslist.size(); }
+    Building* getbuilding(Handle h);
+    // Leitura direta do armazenamento, para visoes (ex.: modelos do Qt).
+    const BuildingRegistry& buildings() { materializar(); return _buildings; }
+    const TurnEngine& engine() const { return _engine; }
+    // Poe em dia o estoque guardado antes de ler engine().columns() inteiro.
+    void sync() { _engine.sync(); }
+    void buildingsnear(int x, int y, int radius, std::vector<SpatialIndex::Entry>& out, uint32_t typemask = 0);
+    Handle nearestbuilding(int x, int y, uint32_t typemask = 0);
+    bool buy(uint32_t product, int price, int qty);
+    bool sell(uint32_t product, int price, int qty);
+    OrderBook::Result marketresult(uint32_t product) const;
+    RecipeBook& recipes() { return _recipes; }
+    bool estocar(size_t index, uint32_t product, float qty);
+    const Inventory& inventory() { return _inventory; }
     void passarturno();
+    void reset();
+    bool salvar(const std::string& path);
+    bool carregar(const std::string& path);
+    bool abrirlivro(const std::string& path);
+    bool conferirlivro();
+    const CashBook& cashbook() const { return _cashbook; }
+    void setSeed(uint64_t seed) { _seed = seed; }
+    uint64_t seed() const { return _seed; }
+    // Sorteios da entidade (uniqueID do building, indice da company...) no
+    // turno atual; o mesmo resultado em qualquer thread e ordem.
+    RandomStream random(uint64_t entity, RngPurpose purpose) const { return RandomStream(_seed, _engine.turn(), entity, purpose); }
+    // Copia O(1) do mundo para rodar "e se" em paralelo (ver fork.hpp).
+    WorldFork fork() const { return WorldFork(_engine, _cashbook, _seed); }
 
 };
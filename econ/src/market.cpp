@@ -0,0 +1,173 @@
+#include <algorithm>
+#include "market.hpp"
+
+OrderBook::OrderBook(int32_t levels)
+{
+    _levels = levels > 0 ? levels : 1;
+    _bidqty.assign(_levels, 0);
+    _askqty.assign(_levels, 0);
+    _demand.assign(_levels, 0);
+    _supply.assign(_levels, 0);
+    _fill.assign(_levels, 0);
+    _last = Result{-1, 0};
+}
+
+bool OrderBook::bid(uint32_t company, int32_t price, int32_t qty)
+{
+    if (price < 0 || price >= _levels || qty <= 0) return false;
+    _bids.push_back(Order{company, price, qty, 0});
+    return true;
+}
+
+bool OrderBook::ask(uint32_t company, int32_t price, int32_t qty)
+{
+    if (price < 0 || price >= _levels || qty <= 0) return false;
+    _asks.push_back(Order{company, price, qty, 0});
+    return true;
+}
+
+void OrderBook::reset(void)
+{
+    _bids.clear();
+    _asks.clear();
+}
+
+// Distribui "volume" entre as ordens: niveis mais agressivos primeiro
+// (compras do preco mais alto, vendas do mais baixo); no nivel marginal
+// quem chegou primeiro leva.
+void OrderBook::allocate(std::vector<Order>& orders, const std::vector<int64_t>& levelqty, int32_t price, int64_t volume, bool buy)
+{
+    int64_t* fill = _fill.data();
+    std::fill(_fill.begin(), _fill.end(), 0);
+    if (buy){
+        for (int32_t p = _levels - 1; p >= price && volume > 0; p--){
+            fill[p] = std::min(levelqty[p], volume);
+            volume -= fill[p];
+        }
+    } else {
+        for (int32_t p = 0; p <= price && volume > 0; p++){
+            fill[p] = std::min(levelqty[p], volume);
+            volume -= fill[p];
+        }
+    }
+    for (Order& o : orders){
+        int32_t f = (int32_t)std::min<int64_t>(o.qty, fill[o.price]);
+        o.filled = f;
+        fill[o.price] -= f;
+    }
+}
+
+OrderBook::Result OrderBook::clear(void)
+{
+    const int32_t n = _levels;
+    int64_t* bidqty = _bidqty.data();
+    int64_t* askqty = _askqty.data();
+    int64_t* demand = _demand.data();
+    int64_t* supply = _supply.data();
+
+    // Histograma por nivel de preco.
+    std::fill(_bidqty.begin(), _bidqty.end(), 0);
+    std::fill(_askqty.begin(), _askqty.end(), 0);
+    for (const Order& o : _bids) bidqty[o.price] += o.qty;
+    for (const Order& o : _asks) askqty[o.price] += o.qty;
+
+    // Demanda a p: compras com limite >= p. Oferta a p: vendas com limite <= p.
+    int64_t acc = 0;
+    for (int32_t p = n - 1; p >= 0; p--){ acc += bidqty[p]; demand[p] = acc; }
+    acc = 0;
+    for (int32_t p = 0; p < n; p++){ acc += askqty[p]; supply[p] = acc; }
+
+    // Varredura sem desvios (vetorizavel): volume executavel em cada nivel
+    // e o maximo; depois o primeiro nivel que atinge o maximo.
+    int64_t best = 0;
+    for (int32_t p = 0; p < n; p++){
+        int64_t v = demand[p] < supply[p] ? demand[p] : supply[p];
+        demand[p] = v; // reaproveita o vetor: agora e o volume no nivel
+        best = v > best ? v : best;
+    }
+    _last = Result{-1, 0};
+    for (Order& o : _bids) o.filled = 0;
+    for (Order& o : _asks) o.filled = 0;
+    if (best == 0) return _last;
+
+    int32_t price = 0;
+    while (demand[price] != best) price++;
+    allocate(_bids, _bidqty, price, best, true);
+    allocate(_asks, _askqty, price, best, false);
+    _last = Result{price, best};
+    return _last;
+}
+
+Market::Market(int32_t levels)
+{
+    _levels = levels;
+    _cleared = 0;
+}
+
+OrderBook& Market::book(uint32_t product)
+{
+    while (_books.size() <= product){
+        _books.emplace_back(_levels);
+        _isdirty.push_back(0);
+    }
+    if (!_isdirty[product]){
+        _isdirty[product] = 1;
+        _dirty.push_back(product);
+    }
+    return _books[product];
+}
+
+const OrderBook* Market::find(uint32_t product) const
+{
+    return product < _books.size() ? &_books[product] : nullptr;
+}
+
+bool Market::bid(uint32_t product, uint32_t company, int32_t price, int32_t qty)
+{
+    return book(product).bid(company, price, qty);
+}
+
+bool Market::ask(uint32_t product, uint32_t company, int32_t price, int32_t qty)
+{
+    return book(product).ask(company, price, qty);
+}
+
+void Market::clear(size_t ncompanies, ThreadPool* pool)
+{
+    _cleared = _dirty.size();
+    if (pool != nullptr){
+        pool->parallelFor(_dirty.size(), 1, [this](size_t begin, size_t end, size_t){
+            for (size_t i = begin; i < end; i++) _books[_dirty[i]].clear();
+        });
+    } else {
+        for (uint32_t p : _dirty) _books[p].clear();
+    }
+
+    // Liquidacao em ordem fixa de produto e de ordem: mesmo resultado com
+    // qualquer numero de threads.
+    _cashdelta.assign(ncompanies, 0);
+    for (uint32_t p : _dirty){
+        const OrderBook& b = _books[p];
+        int64_t price = b.last().price;
+        if (price < 0) continue;
+        for (const OrderBook::Order& o : b.bids()){
+            if (o.filled > 0 && o.company < ncompanies) _cashdelta[o.company] -= o.filled * price;
+        }
+        for (const OrderBook::Order& o : b.asks()){
+            if (o.filled > 0 && o.company < ncompanies) _cashdelta[o.company] += o.filled * price;
+        }
+    }
+}
+
+// Descarta as ordens do turno. Quem negociou fica na lista mais um turno:
+// o proximo clear() (sem ordens) volta o last() dele para "nada executou".
+void Market::reset(void)
+{
+    size_t keep = 0;
+    for (uint32_t p : _dirty){
+        _books[p].reset();
+        if (_books[p].last().price >= 0) _dirty[keep++] = p;
+        else _isdirty[p] = 0;
+    }
+    _dirty.resize(keep);
+}
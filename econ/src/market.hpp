@@ -0,0 +1,75 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "threadpool.hpp"
+
+using namespace std;
+
+// Mercado de um produto: leilao de chamada por turno. As ordens do turno
+// sao agregadas por nivel de preco (vetores de "levels" posicoes), o preco
+// de equilibrio e o que executa mais volume, e todos os negocios saem a esse
+// preco unico. Prioridade por preco e, dentro do nivel, por ordem de chegada.
+class OrderBook {
+    public:
+        struct Order {
+            uint32_t company; // indice em Manager::companieslist
+            int32_t price;    // em ticks, 0 .. levels-1
+            int32_t qty;
+            int32_t filled;   // preenchido por clear()
+        };
+
+        struct Result {
+            int32_t price;    // -1 se nada executou
+            int64_t volume;
+        };
+
+        explicit OrderBook(int32_t levels = 1024);
+
+        bool bid(uint32_t company, int32_t price, int32_t qty);
+        bool ask(uint32_t company, int32_t price, int32_t qty);
+        Result clear(void); // executa o leilao; as ordens ficam ate reset()
+        void reset(void);   // descarta as ordens do turno
+
+        const std::vector<Order>& bids(void) const { return _bids; }
+        const std::vector<Order>& asks(void) const { return _asks; }
+        const Result& last(void) const { return _last; }
+        size_t orders(void) const { return _bids.size() + _asks.size(); }
+
+    private:
+        int32_t _levels;
+        std::vector<Order> _bids, _asks;
+        std::vector<int64_t> _bidqty, _askqty; // quantidade por nivel
+        std::vector<int64_t> _demand, _supply; // acumulados por nivel
+        std::vector<int64_t> _fill;            // quanto executa em cada nivel
+        Result _last;
+
+        void allocate(std::vector<Order>& orders, const std::vector<int64_t>& levelqty, int32_t price, int64_t volume, bool buy);
+};
+
+// Um OrderBook por produto. clear() roda os leiloes (em paralelo se
+// houver pool) e devolve a variacao de caixa de cada company. So os livros
+// mexidos no turno (book(), bid, ask) e os que negociaram no turno anterior
+// (para zerar last()) entram no clear; o resto fica parado.
+class Market {
+    private:
+        std::vector<OrderBook> _books;
+        std::vector<int64_t> _cashdelta;
+        std::vector<uint32_t> _dirty;  // produtos a rodar no proximo clear()
+        std::vector<uint8_t> _isdirty;
+        size_t _cleared;               // livros no ultimo clear()
+        int32_t _levels;
+
+    public:
+        explicit Market(int32_t levels = 1024);
+
+        OrderBook& book(uint32_t product); // cria se preciso e entra no proximo clear()
+        const OrderBook* find(uint32_t product) const; // so leitura; nullptr se nao existe
+        size_t products(void) const { return _books.size(); }
+        bool bid(uint32_t product, uint32_t company, int32_t price, int32_t qty);
+        bool ask(uint32_t product, uint32_t company, int32_t price, int32_t qty);
+        void clear(size_t ncompanies, ThreadPool* pool = nullptr);
+        int64_t cashdelta(size_t company) const { return company < _cashdelta.size() ? _cashdelta[company] : 0; }
+        size_t touched(void) const { return _cleared; }
+        void reset(void);
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+// Dinheiro em ponto fixo: int64 de centavos. Soma, subtracao e conversao
+// saturam em vez de estourar (um caixa de 9.2e16 unidades para no limite);
+// CashBook conta quantas vezes isso aconteceu.
+struct Money {
+    static const int64_t scale = 100; // centavos por unidade
+    static const int64_t max = INT64_MAX;
+    static const int64_t min = INT64_MIN;
+
+    int64_t cents = 0;
+
+    Money(void) {}
+    static Money fromCents(int64_t c) { Money m; m.cents = c; return m; }
+    static Money units(int64_t u) {
+        int64_t c;
+        if (__builtin_mul_overflow(u, scale, &c)) c = u < 0 ? min : max;
+        return fromCents(c);
+    }
+    // Arredonda para o centavo mais proximo (1.15 * 20 = 23.00, sem truncar).
+    static Money fromDouble(double v) {
+        double c = std::round(v * scale);
+        if (!(c < 9.2e18)) return fromCents(max); // inclui NaN
+        if (c < -9.2e18) return fromCents(min);
+        return fromCents((int64_t)c);
+    }
+
+    int64_t whole(void) const { return cents / scale; }
+    double toDouble(void) const { return (double)cents / scale; }
+    Money scaled(double rate) const { return fromDouble(toDouble() * rate); }
+
+    static int64_t satadd(int64_t a, int64_t b) {
+        int64_t r;
+        if (__builtin_add_overflow(a, b, &r)) return b > 0 ? max : min;
+        return r;
+    }
+    static int64_t satsub(int64_t a, int64_t b) {
+        int64_t r;
+        if (__builtin_sub_overflow(a, b, &r)) return b < 0 ? max : min;
+        return r;
+    }
+    static int64_t satmul(int64_t a, int64_t b) {
+        int64_t r;
+        if (__builtin_mul_overflow(a, b, &r)) return (a < 0) != (b < 0) ? min : max;
+        return r;
+    }
+
+    Money operator+(Money o) const { return fromCents(satadd(cents, o.cents)); }
+    Money operator-(Money o) const { return fromCents(satsub(cents, o.cents)); }
+    Money operator-(void) const { return fromCents(cents == min ? max : -cents); }
+    Money& operator+=(Money o) { cents = satadd(cents, o.cents); return *this; }
+    Money& operator-=(Money o) { cents = satsub(cents, o.cents); return *this; }
+    bool operator==(Money o) const { return cents == o.cents; }
+    bool operator!=(Money o) const { return cents != o.cents; }
+    bool operator<(Money o) const { return cents < o.cents; }
+
+    // "-12.05"
+    std::string str(void) const {
+        uint64_t mag = cents < 0 ? 0 - (uint64_t)cents : (uint64_t)cents;
+        std::string frac = std::to_string(mag % scale);
+        if (frac.size() < 2) frac = "0" + frac;
+        return (cents < 0 ? "-" : "") + std::to_string(mag / scale) + "." + frac;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, Money m) { return os << m.str(); }
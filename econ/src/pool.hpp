@@ -0,0 +1,99 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <new>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Contadores de alocacao de um pool, para conferir que criar objetos nao
+// chama malloc fora da troca de bloco. So contam os blocos do pool: o
+// caminho inteiro (registro, colunas, indice espacial...) e medido com um
+// operator new global no bench/churnbench.cpp.
+struct PoolStats {
+    uint64_t constructed = 0; // objetos construidos desde o ultimo clear
+    uint64_t destroyed = 0;   // objetos destruidos individualmente
+    uint64_t blocks = 0;      // blocos alocados no heap (chamadas a new)
+    uint64_t bytes = 0;       // bytes reservados nos blocos
+};
+
+// Pool tipado em blocos: os objetos ficam lado a lado na memoria e os
+// enderecos nunca mudam (blocos nao sao realocados). clear() destroi tudo
+// e devolve os blocos de uma vez so.
+template <typename T, size_t BlockSize = 256>
+class ObjectPool {
+    private:
+        struct Slot {
+            union {
+                Slot* next;
+                alignas(T) unsigned char storage[sizeof(T)];
+            };
+            bool alive;
+        };
+        std::vector<Slot*> _blocks;
+        Slot* _freelist;
+        size_t _used;             // slots ja entregues no ultimo bloco
+        PoolStats _stats;
+
+        Slot* grab(void){
+            if (_freelist != nullptr){
+                Slot* s = _freelist;
+                _freelist = s->next;
+                return s;
+            }
+            if (_blocks.empty() || _used == BlockSize){
+                _blocks.push_back(static_cast<Slot*>(::operator new(sizeof(Slot) * BlockSize)));
+                _used = 0;
+                _stats.blocks++;
+                _stats.bytes += sizeof(Slot) * BlockSize;
+            }
+            return &_blocks.back()[_used++];
+        }
+
+    public:
+        ObjectPool(void) : _freelist(nullptr), _used(0) {}
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
+        ~ObjectPool(void) { clear(); }
+
+        template <typename... Args>
+        T* create(Args&&... args){
+            Slot* s = grab();
+            T* obj = new (s->storage) T(std::forward<Args>(args)...);
+            s->alive = true;
+            _stats.constructed++;
+            return obj;
+        }
+
+        void destroy(T* obj){
+            if (obj == nullptr) return;
+            Slot* s = reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(obj) - offsetof(Slot, storage));
+            obj->~T();
+            s->alive = false;
+            s->next = _freelist;
+            _freelist = s;
+            _stats.destroyed++;
+        }
+
+        // Destroi todos os objetos vivos e libera os blocos.
+        void clear(void){
+            for (size_t b = 0; b < _blocks.size(); b++){
+                size_t n = (b + 1 == _blocks.size()) ? _used : BlockSize;
+                for (size_t i = 0; i < n; i++){
+                    if (_blocks[b][i].alive){
+                        reinterpret_cast<T*>(_blocks[b][i].storage)->~T();
+                    }
+                }
+                ::operator delete(_blocks[b]);
+            }
+            _blocks.clear();
+            _freelist = nullptr;
+            _used = 0;
+            _stats = PoolStats();
+        }
+
+        size_t size(void) const { return (size_t)(_stats.constructed - _stats.destroyed); }
+        const PoolStats& stats(void) const { return _stats; }
+};
@@ -0,0 +1,113 @@
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include "profiler.hpp"
+
+std::atomic<bool> Profiler::enabled(false);
+std::atomic<uint64_t> Profiler::_turn(0);
+std::mutex Profiler::_registry;
+std::vector<Profiler::ThreadBuffer*> Profiler::_buffers;
+
+namespace {
+    const std::chrono::steady_clock::time_point profilerstart = std::chrono::steady_clock::now();
+}
+
+// Nunca retorna 0, que o ProfileScope usa como "desligado".
+uint64_t Profiler::now(void)
+{
+    return 1 + (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - profilerstart).count();
+}
+
+// Os buffers vivem ate o fim do programa: o export pode ler o de uma thread
+// que ja terminou.
+Profiler::ThreadBuffer& Profiler::local(void)
+{
+    static thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr){
+        std::lock_guard<std::mutex> lock(_registry);
+        buffer = new ThreadBuffer();
+        buffer->tid = (uint32_t)_buffers.size();
+        buffer->events.reserve(4096);
+        _buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end)
+{
+    local().events.push_back(Event{name, start, end - start, 0, _turn.load(std::memory_order_relaxed), 'X'});
+}
+
+void Profiler::counter(const char* name, int64_t value)
+{
+    local().events.push_back(Event{name, now(), 0, value, _turn.load(std::memory_order_relaxed), 'C'});
+}
+
+void Profiler::clear(void)
+{
+    std::lock_guard<std::mutex> lock(_registry);
+    for (ThreadBuffer* b : _buffers) b->events.clear();
+}
+
+size_t Profiler::events(void)
+{
+    std::lock_guard<std::mutex> lock(_registry);
+    size_t n = 0;
+    for (ThreadBuffer* b : _buffers) n += b->events.size();
+    return n;
+}
+
+bool Profiler::exportChromeTrace(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(_registry);
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == nullptr) return false;
+    fprintf(f, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (ThreadBuffer* b : _buffers){
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                first ? "" : ",\n", b->tid, b->tid);
+        first = false;
+        for (const Event& e : b->events){
+            if (e.type == 'X'){
+                fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"turn\":%llu}}",
+                        e.name, b->tid, e.start / 1000.0, e.dur / 1000.0, (unsigned long long)e.turn);
+            } else {
+                fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                        e.name, b->tid, e.start / 1000.0, (long long)e.value);
+            }
+        }
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
+
+// Uma linha por (turno, nome): intervalos somam tempo e contam ocorrencias
+// (somando todas as threads); contadores guardam o ultimo valor.
+bool Profiler::exportCsv(const std::string& path)
+{
+    struct Row { double ms = 0; uint64_t count = 0; int64_t value = 0; char type = 'X'; };
+    std::map<std::pair<uint64_t, std::string>, Row> rows;
+    {
+        std::lock_guard<std::mutex> lock(_registry);
+        for (ThreadBuffer* b : _buffers){
+            for (const Event& e : b->events){
+                Row& r = rows[std::make_pair(e.turn, std::string(e.name))];
+                r.type = e.type;
+                r.count++;
+                if (e.type == 'X') r.ms += e.dur / 1e6;
+                else r.value = e.value;
+            }
+        }
+    }
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == nullptr) return false;
+    fprintf(f, "turn,name,kind,total_ms,count,value\n");
+    for (const auto& it : rows){
+        const Row& r = it.second;
+        fprintf(f, "%llu,%s,%s,%.6f,%llu,%lld\n", (unsigned long long)it.first.first, it.first.second.c_str(),
+                r.type == 'X' ? "scope" : "counter", r.ms, (unsigned long long)r.count, (long long)r.value);
+    }
+    return fclose(f) == 0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+// Cronometros por fase do turno. Cada thread grava num buffer proprio (sem
+// lock: um so escritor por buffer); o export le todos os buffers e deve ser
+// chamado entre turnos, com as threads paradas.
+//
+// Desligado em tempo de execucao, PROFILE_SCOPE custa um teste de bool.
+// Compilando com -DECON_NO_PROFILER as macros somem.
+class Profiler {
+    public:
+        struct Event {
+            const char* name; // literal: o ponteiro vale ate o fim do programa
+            uint64_t start;   // ns desde o inicio do profiler
+            uint64_t dur;     // ns; 0 em contadores
+            int64_t value;    // valor do contador
+            uint64_t turn;
+            char type;        // 'X' intervalo, 'C' contador
+        };
+
+        static std::atomic<bool> enabled;
+
+        static uint64_t now(void);
+        static void setTurn(uint64_t turn) { _turn.store(turn, std::memory_order_relaxed); }
+        static void record(const char* name, uint64_t start, uint64_t end);
+        static void counter(const char* name, int64_t value);
+        static void clear(void);
+        static size_t events(void);
+
+        static bool exportChromeTrace(const std::string& path); // chrome://tracing, Perfetto
+        static bool exportCsv(const std::string& path);         // resumo por turno e fase
+
+    private:
+        struct ThreadBuffer {
+            uint32_t tid;
+            std::vector<Event> events;
+        };
+
+        static std::atomic<uint64_t> _turn;
+        static std::mutex _registry; // so para registrar threads novas e exportar
+        static std::vector<ThreadBuffer*> _buffers;
+        static ThreadBuffer& local(void);
+};
+
+class ProfileScope {
+    private:
+        const char* _name;
+        uint64_t _start;
+    public:
+        explicit ProfileScope(const char* name)
+            : _name(name), _start(Profiler::enabled.load(std::memory_order_relaxed) ? Profiler::now() : 0) {}
+        ~ProfileScope(void) { if (_start != 0) Profiler::record(_name, _start, Profiler::now()); }
+};
+
+#ifdef ECON_NO_PROFILER
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_COUNTER(name, value) do {} while (0)
+#else
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(_profile_, __LINE__)(name)
+#define PROFILE_COUNTER(name, value) \
+    do { if (Profiler::enabled.load(std::memory_order_relaxed)) Profiler::counter((name), (value)); } while (0)
+#endif
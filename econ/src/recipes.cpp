@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include "recipes.hpp"
+#include "buildings.hpp"
+#include "money.hpp"
+
+uint32_t RecipeBook::addProduct(const std::string& name, int64_t basecost)
+{
+    Node n;
+    n.name = name;
+    n.uid = IDGenerator::getnewProductID();
+    n.basecost = basecost;
+    n.cost = basecost;
+    n.dirty = false;
+    _nodes.push_back(n);
+    uint32_t id = (uint32_t)_nodes.size() - 1;
+    // Sem ingredientes, pode ir para o fim da ordem sem refazer nada.
+    _rank.push_back((uint32_t)_order.size());
+    _order.push_back(id);
+    return id;
+}
+
+// true se "target" e ingrediente (direto ou indireto) de "from".
+bool RecipeBook::reaches(uint32_t from, uint32_t target) const
+{
+    std::vector<uint32_t> stack(1, from);
+    std::vector<bool> seen(_nodes.size(), false);
+    while (!stack.empty()){
+        uint32_t p = stack.back();
+        stack.pop_back();
+        if (p == target) return true;
+        if (seen[p]) continue;
+        seen[p] = true;
+        for (const Ingredient& i : _nodes[p].ingredients) stack.push_back(i.product);
+    }
+    return false;
+}
+
+bool RecipeBook::setRecipe(uint32_t product, const std::vector<Ingredient>& ingredients)
+{
+    if (product >= _nodes.size()) return false;
+    for (const Ingredient& i : ingredients){
+        if (i.product >= _nodes.size() || i.qty < 0 || reaches(i.product, product)) return false;
+    }
+    Node& n = _nodes[product];
+    for (const Ingredient& i : n.ingredients){
+        std::vector<uint32_t>& c = _nodes[i.product].consumers;
+        c.erase(std::remove(c.begin(), c.end(), product), c.end());
+    }
+    // Ingrediente repetido vira um so com a soma das quantidades: sort()
+    // conta uma aresta por ingrediente e consumers nao tem repetidos.
+    n.ingredients.clear();
+    for (const Ingredient& i : ingredients){
+        auto same = std::find_if(n.ingredients.begin(), n.ingredients.end(),
+                                 [&](const Ingredient& j){ return j.product == i.product; });
+        if (same != n.ingredients.end()) same->qty = (int32_t)std::min<int64_t>(INT32_MAX, (int64_t)same->qty + i.qty);
+        else n.ingredients.push_back(i);
+    }
+    for (const Ingredient& i : n.ingredients){
+        std::vector<uint32_t>& c = _nodes[i.product].consumers;
+        if (std::find(c.begin(), c.end(), product) == c.end()) c.push_back(product);
+        if (_rank[i.product] > _rank[product]) _reorder = true;
+    }
+    markDirty(product);
+    return true;
+}
+
+bool RecipeBook::setBaseCost(uint32_t product, int64_t basecost)
+{
+    if (product >= _nodes.size()) return false;
+    if (_nodes[product].basecost == basecost) return true;
+    _nodes[product].basecost = basecost;
+    markDirty(product);
+    return true;
+}
+
+void RecipeBook::markDirty(uint32_t product)
+{
+    if (!_nodes[product].dirty){
+        _nodes[product].dirty = true;
+        _dirty.push_back(product);
+    }
+}
+
+// Kahn: ingredientes antes de quem os usa.
+void RecipeBook::sort(void)
+{
+    std::vector<uint32_t> pending(_nodes.size());
+    std::vector<uint32_t> ready;
+    for (uint32_t p = 0; p < _nodes.size(); p++){
+        pending[p] = (uint32_t)_nodes[p].ingredients.size();
+        if (pending[p] == 0) ready.push_back(p);
+    }
+    _order.clear();
+    for (size_t k = 0; k < ready.size(); k++){
+        uint32_t p = ready[k];
+        _order.push_back(p);
+        for (uint32_t c : _nodes[p].consumers){
+            if (--pending[c] == 0) ready.push_back(c);
+        }
+    }
+    for (uint32_t i = 0; i < _order.size(); i++) _rank[_order[i]] = i;
+    _reorder = false;
+}
+
+// Recalcula a partir dos produtos sujos, sempre pelo menor rank primeiro:
+// quando um produto sai da fila, todos os seus ingredientes ja estao certos.
+size_t RecipeBook::update(void)
+{
+    if (_reorder) sort();
+    if (_dirty.empty()) return 0;
+
+    typedef std::pair<uint32_t, uint32_t> Item; // (rank, produto)
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    for (uint32_t p : _dirty) queue.push(Item(_rank[p], p));
+    _dirty.clear();
+
+    size_t touched = 0;
+    while (!queue.empty()){
+        uint32_t p = queue.top().second;
+        queue.pop();
+        Node& n = _nodes[p];
+        if (!n.dirty) continue; // ja processado (entrou duas vezes na fila)
+        n.dirty = false;
+        touched++;
+
+        int64_t cost = n.basecost;
+        for (const Ingredient& i : n.ingredients) cost = Money::satadd(cost, Money::satmul(i.qty, _nodes[i.product].cost));
+        if (cost == n.cost) continue; // nada muda para quem depende deste
+        n.cost = cost;
+        for (uint32_t c : n.consumers){
+            if (!_nodes[c].dirty){
+                _nodes[c].dirty = true;
+                queue.push(Item(_rank[c], c));
+            }
+        }
+    }
+    return touched;
+}
+
+int64_t RecipeBook::cost(uint32_t product)
+{
+    if (!_dirty.empty() || _reorder) update();
+    return _nodes[product].cost;
+}
+
+// Desce a ordem topologica de tras para frente: cada produto repassa sua
+// necessidade aos ingredientes depois de ter recebido a de todos que o usam.
+void RecipeBook::needs(uint32_t product, int64_t qty, std::vector<int64_t>& needs)
+{
+    if (_reorder) sort();
+    needs.assign(_nodes.size(), 0);
+    if (product >= _nodes.size()) return;
+    needs[product] = qty;
+    for (size_t k = _rank[product] + 1; k-- > 0;){
+        uint32_t p = _order[k];
+        if (needs[p] == 0) continue;
+        for (const Ingredient& i : _nodes[p].ingredients) needs[i.product] = Money::satadd(needs[i.product], Money::satmul(needs[p], i.qty));
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Receitas de producao (Product.Ingredients do diagrama) como grafo
+// aciclico. Custo unitario = custo base + soma(qtd * custo do ingrediente),
+// saturando como Money (DAGs fundos e largos passam de int64).
+// Os produtos ficam em ordem topologica; quando um custo base muda, so os
+// produtos que dependem dele sao recalculados, em ordem, e a propagacao
+// para onde o custo recalculado nao mudou.
+class RecipeBook {
+    public:
+        struct Ingredient {
+            uint32_t product;
+            int32_t qty;
+        };
+
+        uint32_t addProduct(const std::string& name, int64_t basecost);
+        // false se criar ciclo; ingredientes repetidos sao somados.
+        bool setRecipe(uint32_t product, const std::vector<Ingredient>& ingredients);
+        bool setBaseCost(uint32_t product, int64_t basecost);
+        size_t update(void); // recalcula o que esta sujo; retorna quantos produtos tocou
+
+        size_t size(void) const { return _nodes.size(); }
+        int64_t cost(uint32_t product);
+        uint64_t uniqueProductID(uint32_t product) const { return _nodes[product].uid; }
+        const std::string& name(uint32_t product) const { return _nodes[product].name; }
+        const std::vector<Ingredient>& ingredients(uint32_t product) const { return _nodes[product].ingredients; }
+        // Quantidade de cada produto (inclusive intermediarios) para fazer
+        // qty unidades de "product". needs[p] e indexado por produto.
+        void needs(uint32_t product, int64_t qty, std::vector<int64_t>& needs);
+
+    private:
+        struct Node {
+            std::string name;
+            uint64_t uid;
+            int64_t basecost;
+            int64_t cost;
+            std::vector<Ingredient> ingredients;
+            std::vector<uint32_t> consumers; // produtos que usam este
+            bool dirty;
+        };
+
+        std::vector<Node> _nodes;
+        std::vector<uint32_t> _order; // ordem topologica
+        std::vector<uint32_t> _rank;  // posicao de cada produto em _order
+        std::vector<uint32_t> _dirty; // produtos marcados desde o ultimo update
+        bool _reorder = false;        // receitas mudaram: refazer _order
+
+        void markDirty(uint32_t product);
+        bool reaches(uint32_t from, uint32_t target) const;
+        void sort(void);
+};
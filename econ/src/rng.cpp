@@ -0,0 +1,209 @@
+#include "rng.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ECON_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57; // multiplicadores
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85; // incremento da chave
+    const int rounds = 10;
+
+    uint64_t splitmix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // 24 bits altos -> [0, 1) exato em float.
+    inline float tofloat(uint32_t x) { return (float)(x >> 8) * (1.0f / 16777216.0f); }
+
+    void fillScalar(const uint32_t key[2], uint32_t turn, const uint64_t* entities, size_t n, uint32_t* out)
+    {
+        for (size_t i = 0; i < n; i++){
+            uint32_t ctr[4] = {0, turn, (uint32_t)entities[i], (uint32_t)(entities[i] >> 32)};
+            uint32_t r[4];
+            Philox::block(ctr, key, r);
+            out[i] = r[0];
+        }
+    }
+
+#ifdef ECON_HAVE_AVX2_KERNEL
+    // Produto 32x32 -> 64 de 8 lanes: mul_epu32 so pega as lanes pares,
+    // entao as impares vao num segundo produto e os dois sao intercalados.
+    __attribute__((target("avx2")))
+    inline void mulhilo(__m256i a, __m256i m, __m256i& hi, __m256i& lo)
+    {
+        __m256i even = _mm256_mul_epu32(a, m);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+        lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    }
+
+    // Mesmo Philox da versao escalar, com cada palavra do contador num
+    // registrador de 8 lanes (uma entidade por lane).
+    __attribute__((target("avx2")))
+    void fillAvx2(const uint32_t key[2], uint32_t turn, const uint64_t* entities, size_t n, uint32_t* out)
+    {
+        const __m256i m0 = _mm256_set1_epi32((int)M0), m1 = _mm256_set1_epi32((int)M1);
+        const __m256i lowmask = _mm256_set1_epi64x(0xFFFFFFFF);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8){
+            // entidades 0..3 e 4..7: separa palavras baixa e alta e junta em 8 lanes
+            __m256i e0 = _mm256_loadu_si256((const __m256i*)(entities + i));
+            __m256i e1 = _mm256_loadu_si256((const __m256i*)(entities + i + 4));
+            __m256i lo = _mm256_or_si256(_mm256_and_si256(e0, lowmask), _mm256_slli_epi64(e1, 32));
+            __m256i hi = _mm256_or_si256(_mm256_srli_epi64(e0, 32), _mm256_andnot_si256(lowmask, e1));
+            // lanes ficam na ordem 0,4,1,5,2,6,3,7; desfeito na saida
+            __m256i c0 = _mm256_setzero_si256();
+            __m256i c1 = _mm256_set1_epi32((int)turn);
+            __m256i c2 = lo, c3 = hi;
+            uint32_t k0 = key[0], k1 = key[1];
+            for (int r = 0; r < rounds; r++){
+                __m256i hi0, lo0, hi1, lo1;
+                mulhilo(c0, m0, hi0, lo0);
+                mulhilo(c2, m1, hi1, lo1);
+                __m256i n0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32((int)k0));
+                __m256i n2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32((int)k1));
+                c0 = n0;
+                c1 = lo1;
+                c2 = n2;
+                c3 = lo0;
+                k0 += W0;
+                k1 += W1;
+            }
+            // lanes 0,4,1,5,2,6,3,7 -> 0..7
+            __m256i ordered = _mm256_permutevar8x32_epi32(c0, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+            _mm256_storeu_si256((__m256i*)(out + i), ordered);
+        }
+        fillScalar(key, turn, entities + i, n - i, out + i);
+    }
+#endif
+
+    RandomBulk::Kernel pickKernel(void)
+    {
+        RandomBulk::Kernel k = RandomBulk::avx2Kernel();
+        return k != nullptr ? k : RandomBulk::scalarKernel();
+    }
+
+    RandomBulk::Kernel bulkKernel = pickKernel();
+}
+
+void Philox::block(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4])
+{
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int r = 0; r < rounds; r++){
+        uint64_t p0 = (uint64_t)M0 * c0;
+        uint64_t p1 = (uint64_t)M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += W0;
+        k1 += W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+void Philox::key(uint64_t seed, uint32_t purpose, uint32_t out[2])
+{
+    uint64_t k = splitmix(seed ^ splitmix(purpose));
+    out[0] = (uint32_t)k;
+    out[1] = (uint32_t)(k >> 32);
+}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t turn, uint64_t entity, uint32_t purpose)
+{
+    Philox::key(seed, purpose, _key);
+    _ctr[0] = 0;
+    _ctr[1] = (uint32_t)turn;
+    _ctr[2] = (uint32_t)entity;
+    _ctr[3] = (uint32_t)(entity >> 32);
+    _used = 4;
+}
+
+uint32_t RandomStream::next32(void)
+{
+    if (_used == 4){
+        Philox::block(_ctr, _key, _buf);
+        _ctr[0]++;
+        _used = 0;
+    }
+    return _buf[_used++];
+}
+
+uint64_t RandomStream::next64(void)
+{
+    uint64_t lo = next32();
+    return lo | ((uint64_t)next32() << 32);
+}
+
+double RandomStream::uniform(void)
+{
+    return (double)(next64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+float RandomStream::uniformf(void)
+{
+    return tofloat(next32());
+}
+
+// Multiplica e pega a parte alta (Lemire, sem a rejeicao): um sorteio por
+// chamada, que e o que mantem as sequencias alinhadas entre entidades.
+int32_t RandomStream::range(int32_t lo, int32_t hi)
+{
+    uint64_t span = (uint64_t)((int64_t)hi - lo) + 1;
+    return (int32_t)((int64_t)lo + (int64_t)((next32() * span) >> 32));
+}
+
+void RandomBulk::fill32(uint64_t seed, uint64_t turn, uint32_t purpose, const uint64_t* entities, size_t n, uint32_t* out)
+{
+    uint32_t key[2];
+    Philox::key(seed, purpose, key);
+    bulkKernel(key, (uint32_t)turn, entities, n, out);
+}
+
+// Gera em pedacos na pilha e converte, sem buffer do tamanho da coluna.
+void RandomBulk::fillUniform(uint64_t seed, uint64_t turn, uint32_t purpose, const uint64_t* entities, size_t n, float* out)
+{
+    uint32_t key[2];
+    Philox::key(seed, purpose, key);
+    uint32_t tmp[1024];
+    for (size_t i = 0; i < n; i += 1024){
+        size_t m = n - i < 1024 ? n - i : 1024;
+        bulkKernel(key, (uint32_t)turn, entities + i, m, tmp);
+        for (size_t j = 0; j < m; j++) out[i + j] = tofloat(tmp[j]);
+    }
+}
+
+RandomBulk::Kernel RandomBulk::scalarKernel(void)
+{
+    return &fillScalar;
+}
+
+RandomBulk::Kernel RandomBulk::avx2Kernel(void)
+{
+#ifdef ECON_HAVE_AVX2_KERNEL
+    if (__builtin_cpu_supports("avx2")) return &fillAvx2;
+#endif
+    return nullptr;
+}
+
+const char* RandomBulk::kernelName(void)
+{
+    return bulkKernel == &fillScalar ? "scalar" : "avx2";
+}
+
+void RandomBulk::setKernel(Kernel k)
+{
+    bulkKernel = k;
+}
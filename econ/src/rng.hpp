@@ -0,0 +1,64 @@
+#pragma once
+#include <iostream>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Numeros aleatorios sem estado compartilhado: Philox4x32-10 (Salmon et
+// al., Random123). Cada numero e uma funcao pura de (semente do mundo,
+// turno, entidade, finalidade, indice), entao qualquer building sorteia os
+// seus em qualquer thread, em qualquer ordem, com o mesmo resultado bit a
+// bit.
+//
+// Chave (64 bits) = mistura de semente e finalidade.
+// Contador (128 bits) = {indice, turno, entidade baixo, entidade alto}.
+
+enum RngPurpose : uint32_t {
+    RngWorldGen = 1,
+    RngDemand = 2,
+    RngProduction = 3,
+    RngResearch = 4,
+    RngMarket = 5,
+};
+
+struct Philox {
+    // Um bloco: 4 palavras de 32 bits para o contador e a chave dados.
+    static void block(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]);
+    static void key(uint64_t seed, uint32_t purpose, uint32_t out[2]);
+};
+
+// Sequencia de uma entidade num turno. Barata de criar (nao guarda nada
+// alem do contador); gera 4 numeros por bloco.
+class RandomStream {
+    private:
+        uint32_t _key[2];
+        uint32_t _ctr[4];
+        uint32_t _buf[4];
+        unsigned _used; // palavras de _buf ja entregues
+
+    public:
+        RandomStream(uint64_t seed, uint64_t turn, uint64_t entity, uint32_t purpose);
+        uint32_t next32(void);
+        uint64_t next64(void);
+        double uniform(void);            // [0, 1), 53 bits
+        float uniformf(void);            // [0, 1), 24 bits
+        int32_t range(int32_t lo, int32_t hi); // [lo, hi], vies < 2^-32 por intervalo
+};
+
+// Geracao em lote para preencher colunas: out[i] e o primeiro numero da
+// sequencia da entidade entities[i] (igual a RandomStream(...).next32()),
+// entao o valor segue o building mesmo se ele mudar de slot.
+// Usa AVX2 quando a CPU tem, 8 entidades por vez.
+class RandomBulk {
+    public:
+        typedef void (*Kernel)(const uint32_t key[2], uint32_t turn, const uint64_t* entities, size_t n, uint32_t* out);
+
+        static void fill32(uint64_t seed, uint64_t turn, uint32_t purpose, const uint64_t* entities, size_t n, uint32_t* out);
+        static void fillUniform(uint64_t seed, uint64_t turn, uint32_t purpose, const uint64_t* entities, size_t n, float* out);
+
+        static Kernel scalarKernel(void);
+        static Kernel avx2Kernel(void); // nullptr se a CPU nao tiver AVX2
+        static const char* kernelName(void);
+        static void setKernel(Kernel k); // so para benchmarks e testes
+};
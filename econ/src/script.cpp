@@ -0,0 +1,276 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "script.hpp"
+#include "profiler.hpp"
+
+namespace {
+    const char* skipspace(const char* p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        return p;
+    }
+
+    const char* skipword(const char* p, const char* end)
+    {
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r') p++;
+        return p;
+    }
+
+    bool same(const char* cmd, size_t len, const char* word)
+    {
+        return strlen(word) == len && memcmp(cmd, word, len) == 0;
+    }
+
+    // Le um inteiro sem sinal; "next" aponta para depois dele.
+    bool number(const char* p, const char* end, uint64_t& value, const char*& next)
+    {
+        p = skipspace(p, end);
+        if (p == end || *p < '0' || *p > '9') return false;
+        value = 0;
+        while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (uint64_t)(*p++ - '0');
+        next = p;
+        return true;
+    }
+
+    bool integer(const char* p, const char* end, int64_t& value, const char*& next)
+    {
+        p = skipspace(p, end);
+        bool negative = p < end && *p == '-';
+        uint64_t magnitude;
+        if (!number(negative ? p + 1 : p, end, magnitude, next)) return false;
+        value = negative ? -(int64_t)magnitude : (int64_t)magnitude;
+        return true;
+    }
+
+    // Resto da linha sem espacos nas pontas (nomes podem ter espacos).
+    // Aponta para a linha lida: vale so durante o comando.
+    std::string_view rest(const char* p, const char* end)
+    {
+        p = skipspace(p, end);
+        while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;
+        return std::string_view(p, end - p);
+    }
+
+    // As mensagens dos construtores e do passarturno sao para o modo
+    // interativo; no script so as listagens vao para a saida.
+    struct Mute {
+        Mute(void) { cout.setstate(ios::failbit); }
+        ~Mute(void) { cout.clear(); }
+    };
+}
+
+ScriptRunner::ScriptRunner(Manager& manager) : _manager(manager)
+{
+    _commands = 0;
+    _errors = 0;
+    _seconds = 0;
+}
+
+bool ScriptRunner::execute(const char* cmd, size_t cmdlen, const char* args, const char* end)
+{
+    uint64_t n;
+    const char* next;
+    if (same(cmd, cmdlen, "company")){
+        std::string_view nome = rest(args, end);
+        if (nome.empty()) return false;
+        Mute mute;
+        _manager.selectCompany((int)_manager.criarCompany(nome));
+        return true;
+    }
+    if (same(cmd, cmdlen, "select")){
+        if (!number(args, end, n, next) || n >= _manager.ncompanies()) return false;
+        Mute mute;
+        _manager.selectCompany((int)n);
+        return true;
+    }
+    if (same(cmd, cmdlen, "building")){
+        if (!number(args, end, n, next)) return false;
+        std::string_view nome = rest(next, end);
+        if (nome.empty()) return false;
+        Mute mute;
+        return _manager.criabuilding((int)n, nome) != NullHandle;
+    }
+    if (same(cmd, cmdlen, "buildingat")){
+        int64_t x, y;
+        if (!number(args, end, n, next) || !integer(next, end, x, next) || !integer(next, end, y, next)) return false;
+        std::string_view nome = rest(next, end);
+        if (nome.empty()) return false;
+        Mute mute;
+        return _manager.criabuilding((int)n, nome, (int)x, (int)y) != NullHandle;
+    }
+    if (same(cmd, cmdlen, "near")){
+        int64_t x, y, r;
+        if (!integer(args, end, x, next) || !integer(next, end, y, next) || !integer(next, end, r, next)) return false;
+        std::vector<SpatialIndex::Entry> found;
+        _manager.buildingsnear((int)x, (int)y, (int)r, found);
+        cout << found.size() << " buildings\n";
+        for (const SpatialIndex::Entry& e : found){
+            Building* b = _manager.getbuilding(e.handle);
+            cout << b->uniqueID() << " " << b->nome() << " (" << e.x << ", " << e.y << ")\n";
+        }
+        return true;
+    }
+    if (same(cmd, cmdlen, "nearest")){
+        int64_t x, y;
+        if (!integer(args, end, x, next) || !integer(next, end, y, next)) return false;
+        uint32_t mask = number(next, end, n, next) && n < 32 ? (1u << n) : 0;
+        Building* b = _manager.getbuilding(_manager.nearestbuilding((int)x, (int)y, mask));
+        if (b == nullptr) return false;
+        cout << b->uniqueID() << " " << b->nome() << " (" << b->posx() << ", " << b->posy() << ")\n";
+        return true;
+    }
+    if (same(cmd, cmdlen, "bid") || same(cmd, cmdlen, "ask")){
+        uint64_t price, qty;
+        if (!number(args, end, n, next) || !number(next, end, price, next) || !number(next, end, qty, next)) return false;
+        if (n >= Manager::maxproducts) return false;
+        return cmd[0] == 'b' ? _manager.buy((uint32_t)n, (int)price, (int)qty)
+                             : _manager.sell((uint32_t)n, (int)price, (int)qty);
+    }
+    if (same(cmd, cmdlen, "market")){
+        if (!number(args, end, n, next)) return false;
+        OrderBook::Result r = _manager.marketresult((uint32_t)n);
+        cout << "product " << n << " price " << r.price << " volume " << r.volume << "\n";
+        return true;
+    }
+    if (same(cmd, cmdlen, "product")){
+        if (!number(args, end, n, next)) return false;
+        std::string_view nome = rest(next, end);
+        if (nome.empty()) return false;
+        cout << "product " << _manager.recipes().addProduct(std::string(nome), (int64_t)n) << "\n";
+        return true;
+    }
+    if (same(cmd, cmdlen, "recipe")){
+        if (!number(args, end, n, next)) return false;
+        std::vector<RecipeBook::Ingredient> ingredients;
+        uint64_t ing, qty;
+        while (number(next, end, ing, next)){
+            if (!number(next, end, qty, next)) return false;
+            ingredients.push_back(RecipeBook::Ingredient{(uint32_t)ing, (int32_t)qty});
+        }
+        return _manager.recipes().setRecipe((uint32_t)n, ingredients);
+    }
+    if (same(cmd, cmdlen, "basecost")){
+        uint64_t cost;
+        if (!number(args, end, n, next) || !number(next, end, cost, next)) return false;
+        return _manager.recipes().setBaseCost((uint32_t)n, (int64_t)cost);
+    }
+    if (same(cmd, cmdlen, "cost")){
+        if (!number(args, end, n, next) || n >= _manager.recipes().size()) return false;
+        cout << _manager.recipes().name((uint32_t)n) << " " << _manager.recipes().cost((uint32_t)n) << "\n";
+        return true;
+    }
+    if (same(cmd, cmdlen, "stock")){
+        uint64_t product, qty;
+        if (!number(args, end, n, next) || !number(next, end, product, next) || !number(next, end, qty, next)) return false;
+        if (product >= Manager::maxproducts) return false;
+        return _manager.estocar((size_t)n, (uint32_t)product, (float)qty);
+    }
+    if (same(cmd, cmdlen, "inventory")){
+        cout << _manager.inventory().size() << " stock entries, kernel " << Inventory::kernelName() << "\n";
+        return true;
+    }
+    if (same(cmd, cmdlen, "profile")){
+        std::string_view mode = rest(args, end);
+        if (mode != "on" && mode != "off") return false;
+        Profiler::enabled = (mode == "on");
+        return true;
+    }
+    if (same(cmd, cmdlen, "trace")){
+        std::string path(rest(args, end));
+        if (path.empty()) return false;
+        return Profiler::exportChromeTrace(path) && Profiler::exportCsv(path + ".csv");
+    }
+    if (same(cmd, cmdlen, "seed")){
+        if (!number(args, end, n, next)) return false;
+        _manager.setSeed(n);
+        return true;
+    }
+    if (same(cmd, cmdlen, "demolish")){
+        if (!number(args, end, n, next)) return false;
+        return _manager.demolirbuilding((size_t)n);
+    }
+    if (same(cmd, cmdlen, "turn")){
+        if (!number(args, end, n, next)) n = 1;
+        Mute mute;
+        for (uint64_t t = 0; t < n; t++) _manager.passarturno();
+        return true;
+    }
+    if (same(cmd, cmdlen, "companies")){
+        _manager.listCompanies();
+        return true;
+    }
+    if (same(cmd, cmdlen, "buildings")){
+        return _manager.listBuildings();
+    }
+    if (same(cmd, cmdlen, "save") || same(cmd, cmdlen, "load")){
+        std::string path(rest(args, end));
+        if (path.empty()) path = "world.bin";
+        Mute mute;
+        return cmd[0] == 's' ? _manager.salvar(path) : _manager.carregar(path);
+    }
+    if (same(cmd, cmdlen, "reset")){
+        Mute mute;
+        _manager.reset();
+        return true;
+    }
+    return false;
+}
+
+// Le a entrada em blocos grandes e processa linha a linha, sem prompts.
+bool ScriptRunner::run(FILE* input)
+{
+    auto start = chrono::steady_clock::now();
+    std::string buffer;
+    std::vector<char> chunk(1 << 16);
+    size_t got;
+    uint64_t line = 0;
+    bool ok = true;
+
+    while (true){
+        got = fread(chunk.data(), 1, chunk.size(), input);
+        buffer.append(chunk.data(), got);
+        bool eof = got < chunk.size();
+
+        size_t pos = 0;
+        while (true){
+            size_t nl = buffer.find('\n', pos);
+            if (nl == std::string::npos){
+                if (!eof) break;
+                nl = buffer.size(); // ultima linha sem '\n'
+                if (pos >= nl) break;
+            }
+            line++;
+            const char* p = buffer.data() + pos;
+            const char* end = buffer.data() + nl;
+            const char* hash = static_cast<const char*>(memchr(p, '#', end - p));
+            if (hash != nullptr) end = hash;
+            p = skipspace(p, end);
+            if (p < end){
+                const char* cmdend = skipword(p, end);
+                _commands++;
+                if (!execute(p, cmdend - p, cmdend, end)){
+                    _errors++;
+                    ok = false;
+                    fprintf(stderr, "script: line %llu: command failed: %.*s\n",
+                            (unsigned long long)line, (int)(end - p), p);
+                }
+            }
+            pos = nl + 1;
+            if (pos > buffer.size()) break;
+        }
+        buffer.erase(0, std::min(pos, buffer.size()));
+        if (eof) break;
+    }
+
+    _seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.flush();
+    return ok;
+}
+
+void ScriptRunner::report(void) const
+{
+    fprintf(stderr, "script: %llu commands, %llu errors, %.3f s, %.0f commands/s\n",
+            (unsigned long long)_commands, (unsigned long long)_errors, _seconds,
+            _seconds > 0 ? _commands / _seconds : 0.0);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include "manager.hpp"
+
+using namespace std;
+
+// Modo sem menu: le comandos de um arquivo (ou stdin) e aplica no Manager.
+// Um comando por linha, '#' comeca comentario:
+//   company <nome>            cria e seleciona uma company
+//   select <indice>           seleciona company
+//   building <tipo> <nome>    cria building na company selecionada
+//   buildingat <tipo> <x> <y> <nome>   idem, na posicao (x, y)
+//   demolish <indice>         demole building da company selecionada
+//   turn [N]                  passa N turnos (padrao 1)
+//   companies | buildings     listagens
+//   near <x> <y> <raio>       buildings a ate <raio> de (x, y)
+//   nearest <x> <y> [tipo]    building mais proximo (do tipo, se dado)
+//   bid <produto> <preco> <qtd>   ordem de compra da company selecionada
+//                             (produto < Manager::maxproducts)
+//   ask <produto> <preco> <qtd>   ordem de venda
+//   market <produto>          preco e volume do ultimo leilao
+//   product <custo base> <nome>   novo produto do catalogo (mostra o indice)
+//   recipe <produto> <ingrediente> <qtd> [...]   define os ingredientes
+//   basecost <produto> <custo>    muda o custo base
+//   cost <produto>            custo unitario atual
+//   stock <building> <produto> <qtd>   estoque num building da company selecionada
+//                             (produto < Manager::maxproducts)
+//   inventory                 entradas de estoque e kernel em uso
+//   profile on|off            liga/desliga os cronometros do turno
+//   trace <arquivo>           grava <arquivo> (Chrome trace) e <arquivo>.csv
+//   seed <n>                  semente do mundo (sorteios, ver rng.hpp)
+//   save [arquivo] | load [arquivo] | reset
+class ScriptRunner {
+    private:
+        Manager& _manager;
+        uint64_t _commands;
+        uint64_t _errors;
+        double _seconds;
+
+        bool execute(const char* cmd, size_t cmdlen, const char* args, const char* end);
+
+    public:
+        explicit ScriptRunner(Manager& manager);
+        bool run(FILE* input);
+        uint64_t commands(void) const { return _commands; }
+        uint64_t errors(void) const { return _errors; }
+        double seconds(void) const { return _seconds; }
+        void report(void) const; // contador de vazao no stderr
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Handle de 64 bits: indice do slot nos 32 bits baixos e geracao nos altos.
+// Um handle antigo para um slot reaproveitado tem geracao diferente e deixa
+// de ser valido, em vez de apontar para outro objeto.
+typedef uint64_t Handle;
+const Handle NullHandle = 0;
+
+inline uint32_t handleIndex(Handle h) { return (uint32_t)(h & 0xffffffffu); }
+inline uint32_t handleGeneration(Handle h) { return (uint32_t)(h >> 32); }
+inline Handle makeHandle(uint32_t index, uint32_t generation) { return ((uint64_t)generation << 32) | index; }
+
+// Slot map: insert, remove e busca O(1); valores guardados de forma densa
+// para iterar sem buracos.
+template <typename T>
+class SlotMap {
+    private:
+        struct Slot {
+            uint32_t generation; // comeca em 1, assim NullHandle nunca e valido
+            uint32_t dense;      // indice em _values, ou proximo livre
+        };
+        std::vector<Slot> _slots;
+        std::vector<T> _values;
+        std::vector<uint32_t> _owners; // slot de cada valor denso
+        uint32_t _freehead;
+        static const uint32_t npos = 0xffffffffu;
+
+    public:
+        SlotMap(void) : _freehead(npos) {}
+
+        Handle insert(const T& value){
+            uint32_t index;
+            if (_freehead != npos){
+                index = _freehead;
+                _freehead = _slots[index].dense;
+            } else {
+                index = (uint32_t)_slots.size();
+                _slots.push_back(Slot{1, 0});
+            }
+            _slots[index].dense = (uint32_t)_values.size();
+            _values.push_back(value);
+            _owners.push_back(index);
+            return makeHandle(index, _slots[index].generation);
+        }
+
+        // Remove trocando com o ultimo valor denso, assim o vetor continua sem
+        // buracos. A geracao do slot avanca e o slot vai para a lista livre.
+        bool remove(Handle h){
+            if (!contains(h)) return false;
+            uint32_t index = handleIndex(h);
+            uint32_t dense = _slots[index].dense;
+            uint32_t last = (uint32_t)_values.size() - 1;
+            if (dense != last){
+                _values[dense] = _values[last];
+                _owners[dense] = _owners[last];
+                _slots[_owners[dense]].dense = dense;
+            }
+            _values.pop_back();
+            _owners.pop_back();
+            _slots[index].generation++;
+            if (_slots[index].generation == 0) _slots[index].generation = 1;
+            _slots[index].dense = _freehead;
+            _freehead = index;
+            return true;
+        }
+
+        bool contains(Handle h) const {
+            uint32_t index = handleIndex(h);
+            return index < _slots.size() && _slots[index].generation == handleGeneration(h);
+        }
+
+        // Retorna nullptr se o handle nao for (mais) valido.
+        T* get(Handle h){
+            return contains(h) ? &_values[_slots[handleIndex(h)].dense] : nullptr;
+        }
+        const T* get(Handle h) const {
+            return contains(h) ? &_values[_slots[handleIndex(h)].dense] : nullptr;
+        }
+
+        // Indice denso do valor, estavel ate o proximo remove().
+        uint32_t denseIndex(Handle h) const { return _slots[handleIndex(h)].dense; }
+
+        size_t size(void) const { return _values.size(); }
+        T* begin(void) { return _values.data(); }
+        T* end(void) { return _values.data() + _values.size(); }
+        const T* begin(void) const { return _values.data(); }
+        const T* end(void) const { return _values.data() + _values.size(); }
+        T& at(size_t dense) { return _values[dense]; }
+        const T& at(size_t dense) const { return _values[dense]; }
+        Handle handleAt(size_t dense) const {
+            uint32_t index = _owners[dense];
+            return makeHandle(index, _slots[index].generation);
+        }
+
+        // Esvazia mas guarda os slots: quem esta vivo avanca a geracao como
+        // num remove(), entao handle de antes do clear() nao vale para o
+        // que for inserido depois (os livres ja avancaram no remove()).
+        void clear(void){
+            for (uint32_t index : _owners){
+                _slots[index].generation++;
+                if (_slots[index].generation == 0) _slots[index].generation = 1;
+            }
+            _values.clear();
+            _owners.clear();
+            _freehead = npos;
+            for (uint32_t index = (uint32_t)_slots.size(); index-- > 0;){
+                _slots[index].dense = _freehead;
+                _freehead = index;
+            }
+        }
+};
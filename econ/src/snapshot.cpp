@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "snapshot.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char snapshotmagic[8] = {'E','C','O','N','S','N','A','P'};
+
+    uint64_t align8(uint64_t x) { return (x + 7) & ~(uint64_t)7; }
+
+    // Bloco de count itens de itemsize bytes em offset cabe no arquivo e
+    // esta alinhado a 8. Os numeros vem do arquivo: nada de multiplicar ou
+    // somar antes de saber que nao estoura.
+    bool fits(uint64_t offset, uint64_t count, uint64_t itemsize, uint64_t filesize)
+    {
+        if (offset % 8 != 0 || offset > filesize) return false;
+        return count <= (filesize - offset) / itemsize;
+    }
+}
+
+SnapshotFile::SnapshotFile(void)
+{
+    _data = nullptr;
+    _size = 0;
+#ifdef _WIN32
+    _file = nullptr;
+    _mapping = nullptr;
+#else
+    _fd = -1;
+#endif
+}
+
+SnapshotFile::~SnapshotFile(void)
+{
+    close();
+}
+
+void SnapshotFile::close(void)
+{
+#ifdef _WIN32
+    if (_data != nullptr) UnmapViewOfFile(_data);
+    if (_mapping != nullptr) CloseHandle(_mapping);
+    if (_file != nullptr) CloseHandle(_file);
+    _file = nullptr;
+    _mapping = nullptr;
+#else
+    if (_data != nullptr) munmap(_data, _size);
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+#endif
+    _data = nullptr;
+    _size = 0;
+}
+
+bool SnapshotFile::open(const std::string& path)
+{
+    close();
+#ifdef _WIN32
+    // FILE_SHARE_DELETE: o mundo carregado segura o arquivo enquanto usa
+    // as colunas mapeadas, e salvar no mesmo caminho troca o arquivo.
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    _file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(SnapshotHeader)){
+        close();
+        return false;
+    }
+    _size = (size_t)size.QuadPart;
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (_mapping == nullptr){
+        close();
+        return false;
+    }
+    _data = static_cast<unsigned char*>(MapViewOfFile(_mapping, FILE_MAP_COPY, 0, 0, 0));
+#else
+    _fd = ::open(path.c_str(), O_RDONLY);
+    if (_fd < 0) return false;
+    struct stat st;
+    if (fstat(_fd, &st) != 0 || st.st_size < (off_t)sizeof(SnapshotHeader)){
+        close();
+        return false;
+    }
+    _size = (size_t)st.st_size;
+    void* p = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, _fd, 0);
+    _data = (p == MAP_FAILED) ? nullptr : static_cast<unsigned char*>(p);
+#endif
+    if (_data == nullptr){
+        close();
+        return false;
+    }
+
+    // Confere so o cabecalho e os limites; o conteudo e usado como esta.
+    const SnapshotHeader& h = header();
+    if (memcmp(h.magic, snapshotmagic, 8) != 0 || h.version != SnapshotVersion
+        || h.headersize != sizeof(SnapshotHeader) || h.filesize != _size
+        || !fits(h.companiesoffset, h.ncompanies, sizeof(SnapshotCompany), _size)
+        || !fits(h.buildingsoffset, h.nbuildings, sizeof(SnapshotBuilding), _size)
+        || h.nbuildings > _size / (SnapshotColumns * sizeof(int32_t))
+        || !fits(h.columnsoffset, SnapshotColumns * h.nbuildings, sizeof(int32_t), _size)
+        || h.namesoffset > _size){
+        close();
+        return false;
+    }
+    return true;
+}
+
+const SnapshotCompany* SnapshotFile::companies(void) const
+{
+    return reinterpret_cast<const SnapshotCompany*>(_data + header().companiesoffset);
+}
+
+const SnapshotBuilding* SnapshotFile::buildings(void) const
+{
+    return reinterpret_cast<const SnapshotBuilding*>(_data + header().buildingsoffset);
+}
+
+const int32_t* SnapshotFile::column(SnapshotColumn c) const
+{
+    const SnapshotHeader& h = header();
+    return reinterpret_cast<const int32_t*>(_data + h.columnsoffset) + (size_t)c * h.nbuildings;
+}
+
+std::string_view SnapshotFile::name(uint64_t offset, uint32_t len) const
+{
+    const SnapshotHeader& h = header();
+    uint64_t room = _size - h.namesoffset; // namesoffset <= _size, visto no open()
+    if (offset > room || len > room - offset) return std::string_view();
+    return std::string_view(reinterpret_cast<const char*>(_data + h.namesoffset + offset), len);
+}
+
+uint64_t SnapshotWriter::addName(std::string_view name)
+{
+    uint64_t offset = _names.size();
+    _names += name;
+    return offset;
+}
+
+void SnapshotWriter::addCompany(std::string_view name, int64_t cash)
+{
+    SnapshotCompany c;
+    c.cash = cash;
+    c.namelen = (uint32_t)name.size();
+    c.nameoffset = addName(name);
+    c.reserved = 0;
+    _companies.push_back(c);
+}
+
+void SnapshotWriter::addBuilding(uint64_t uniqueID, int type, int x, int y, std::string_view name)
+{
+    SnapshotBuilding b;
+    b.uniqueID = uniqueID;
+    b.namelen = (uint32_t)name.size();
+    b.nameoffset = addName(name);
+    b.type = type;
+    b.x = x;
+    b.y = y;
+    _buildings.push_back(b);
+}
+
+void SnapshotWriter::setColumn(SnapshotColumn c, const CowColumn<int32_t>* column)
+{
+    if (_columns.size() < SnapshotColumns) _columns.resize(SnapshotColumns, nullptr);
+    _columns[c] = column;
+}
+
+bool SnapshotWriter::write(const std::string& path, uint64_t turn, uint64_t seed)
+{
+    const uint64_t nb = _buildings.size();
+    if (_columns.size() < SnapshotColumns) _columns.resize(SnapshotColumns, nullptr);
+    for (const CowColumn<int32_t>* col : _columns){
+        if (col == nullptr || col->size() != nb) return false;
+    }
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, snapshotmagic, 8);
+    h.version = SnapshotVersion;
+    h.headersize = sizeof(SnapshotHeader);
+    h.turn = turn;
+    h.seed = seed;
+    h.ncompanies = _companies.size();
+    h.nbuildings = nb;
+    h.companiesoffset = align8(sizeof(SnapshotHeader));
+    h.buildingsoffset = align8(h.companiesoffset + h.ncompanies * sizeof(SnapshotCompany));
+    h.columnsoffset = align8(h.buildingsoffset + nb * sizeof(SnapshotBuilding));
+    h.namesoffset = align8(h.columnsoffset + SnapshotColumns * nb * sizeof(int32_t));
+    h.filesize = h.namesoffset + _names.size();
+
+    // Grava num arquivo temporario e troca no fim, para nunca deixar um
+    // snapshot pela metade no lugar do anterior.
+    std::string tmppath = path + ".tmp";
+    FILE* f = fopen(tmppath.c_str(), "wb");
+    if (f == nullptr) return false;
+    const char zeros[8] = {0};
+    bool ok = true;
+    auto put = [&](const void* p, size_t n){ if (ok && n > 0) ok = fwrite(p, 1, n, f) == n; };
+    auto pad = [&](uint64_t target){ put(zeros, (size_t)(target - (uint64_t)ftell(f))); };
+
+    put(&h, sizeof(h));
+    pad(h.companiesoffset);
+    put(_companies.data(), _companies.size() * sizeof(SnapshotCompany));
+    pad(h.buildingsoffset);
+    put(_buildings.data(), nb * sizeof(SnapshotBuilding));
+    pad(h.columnsoffset);
+    for (const CowColumn<int32_t>* col : _columns){
+        for (size_t c = 0; c < col->nchunks(); c++){
+            size_t n = std::min((size_t)nb - c * CowColumn<int32_t>::chunksize, CowColumn<int32_t>::chunksize);
+            put(col->chunk(c), n * sizeof(int32_t));
+        }
+    }
+    pad(h.namesoffset);
+    put(_names.data(), _names.size());
+    ok = (fclose(f) == 0) && ok;
+    if (!ok){
+        remove(tmppath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    remove(path.c_str());
+#endif
+    return rename(tmppath.c_str(), path.c_str()) == 0;
+}
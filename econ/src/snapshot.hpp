@@ -0,0 +1,100 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "cow.hpp"
+
+using namespace std;
+
+// Formato binario do mundo salvo. Tudo em blocos alinhados a 8
+// bytes, na ordem nativa da maquina, para ser usado direto do mmap:
+//   SnapshotHeader | SnapshotCompany[ncompanies] | SnapshotBuilding[nbuildings]
+//   | colunas int32 do TurnEngine (SnapshotColumns) | nomes (bytes, sem '\0')
+// A ordem dos buildings e a ordem dos slots do TurnEngine.
+const uint32_t SnapshotVersion = 4; // 2: posicao dos buildings; 3: caixa em centavos; 4: semente
+
+enum SnapshotColumn {
+    ColProduction = 0, ColDemand, ColStock, ColPrice, ColCost, ColOwner,
+    SnapshotColumns
+};
+
+struct SnapshotHeader {
+    char magic[8];        // "ECONSNAP"
+    uint32_t version;
+    uint32_t headersize;
+    uint64_t turn;
+    uint64_t seed;        // semente do mundo (ver rng.hpp)
+    uint64_t ncompanies;
+    uint64_t nbuildings;
+    uint64_t companiesoffset;
+    uint64_t buildingsoffset;
+    uint64_t columnsoffset;
+    uint64_t namesoffset;
+    uint64_t filesize;
+};
+
+struct SnapshotCompany {
+    int64_t cash; // centavos (Money)
+    uint64_t nameoffset;  // relativo ao inicio dos nomes
+    uint32_t namelen;
+    uint32_t reserved;
+};
+
+struct SnapshotBuilding {
+    uint64_t uniqueID;
+    uint64_t nameoffset;
+    uint32_t namelen;
+    int32_t type;
+    int32_t x;
+    int32_t y;
+};
+
+// Arquivo de snapshot mapeado. Abrir nao le nem converte nada: os
+// acessores devolvem ponteiros para dentro do mapeamento. O mapeamento e
+// privado (copy-on-write do sistema): escrever nele nunca muda o arquivo.
+class SnapshotFile {
+    private:
+        unsigned char* _data;
+        size_t _size;
+#ifdef _WIN32
+        void* _file;
+        void* _mapping;
+#else
+        int _fd;
+#endif
+        void close(void);
+
+    public:
+        SnapshotFile(void);
+        ~SnapshotFile(void);
+        SnapshotFile(const SnapshotFile&) = delete;
+        SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+        bool open(const std::string& path);
+        bool valid(void) const { return _data != nullptr; }
+        const SnapshotHeader& header(void) const { return *reinterpret_cast<const SnapshotHeader*>(_data); }
+        const SnapshotCompany* companies(void) const;
+        const SnapshotBuilding* buildings(void) const;
+        const int32_t* column(SnapshotColumn c) const;
+        // A mesma coluna, para uso no lugar (ver CowColumn::share).
+        int32_t* writecolumn(SnapshotColumn c) { return const_cast<int32_t*>(column(c)); }
+        std::string_view name(uint64_t offset, uint32_t len) const;
+};
+
+// Monta o snapshot em memoria e grava de uma vez.
+class SnapshotWriter {
+    private:
+        std::vector<SnapshotCompany> _companies;
+        std::vector<SnapshotBuilding> _buildings;
+        std::vector<const CowColumn<int32_t>*> _columns;
+        std::string _names;
+        uint64_t addName(std::string_view name);
+
+    public:
+        void addCompany(std::string_view name, int64_t cash);
+        void addBuilding(uint64_t uniqueID, int type, int x, int y, std::string_view name);
+        void setColumn(SnapshotColumn c, const CowColumn<int32_t>* column);
+        bool write(const std::string& path, uint64_t turn, uint64_t seed = 0);
+};
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "spatial.hpp"
+
+SpatialIndex::SpatialIndex(int32_t cellsize)
+{
+    _cellsize = cellsize > 0 ? cellsize : 16;
+    clear();
+}
+
+namespace {
+    // x +- radius pode sair do int32; nenhum building esta fora dele.
+    int32_t clampcoord(int64_t v)
+    {
+        return (int32_t)std::min<int64_t>(std::max<int64_t>(v, INT32_MIN), INT32_MAX);
+    }
+
+    // Distancia ao quadrado sem estouro: cada diferenca cabe em 33 bits, o
+    // quadrado em 64 sem sinal e a soma satura.
+    uint64_t distance2(int64_t dx, int64_t dy)
+    {
+        uint64_t ax = (uint64_t)(dx < 0 ? -dx : dx), ay = (uint64_t)(dy < 0 ? -dy : dy);
+        uint64_t a = ax * ax, b = ay * ay;
+        return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+    }
+}
+
+// Divisao arredondando para baixo, tambem para coordenadas negativas.
+int32_t SpatialIndex::cellOf(int32_t v) const
+{
+    return v >= 0 ? v / _cellsize : -((-(int64_t)v + _cellsize - 1) / _cellsize);
+}
+
+const std::vector<SpatialIndex::Entry>* SpatialIndex::cell(int32_t cx, int32_t cy) const
+{
+    auto it = _cells.find(key(cx, cy));
+    return it == _cells.end() ? nullptr : &it->second;
+}
+
+void SpatialIndex::insert(Handle h, int32_t x, int32_t y, int32_t type)
+{
+    int32_t cx = cellOf(x), cy = cellOf(y);
+    _cells[key(cx, cy)].push_back(Entry{h, x, y, type});
+    _typecount[typeslot(type)]++;
+    if (_count == 0){
+        _mincx = _maxcx = cx;
+        _mincy = _maxcy = cy;
+    } else {
+        _mincx = std::min(_mincx, cx); _maxcx = std::max(_maxcx, cx);
+        _mincy = std::min(_mincy, cy); _maxcy = std::max(_maxcy, cy);
+    }
+    _count++;
+}
+
+bool SpatialIndex::remove(Handle h, int32_t x, int32_t y)
+{
+    auto it = _cells.find(key(cellOf(x), cellOf(y)));
+    if (it == _cells.end()) return false;
+    std::vector<Entry>& v = it->second;
+    for (size_t i = 0; i < v.size(); i++){
+        if (v[i].handle == h){
+            _typecount[typeslot(v[i].type)]--;
+            v[i] = v.back();
+            v.pop_back();
+            _count--; // celula vazia fica, com a capacidade: reocupar nao aloca
+            return true;
+        }
+    }
+    return false;
+}
+
+void SpatialIndex::clear(void)
+{
+    _cells.clear();
+    _count = 0;
+    std::fill(_typecount, _typecount + 33, (size_t)0);
+    _mincx = _mincy = _maxcx = _maxcy = 0;
+}
+
+// Quantos buildings passam no filtro.
+size_t SpatialIndex::accepted(uint32_t typemask) const
+{
+    if (typemask == 0) return _count;
+    size_t n = 0;
+    for (int32_t t = 0; t < 32; t++) if (typemask & (1u << t)) n += _typecount[t];
+    return n;
+}
+
+void SpatialIndex::within(int32_t x, int32_t y, int32_t radius, std::vector<Entry>& out, uint32_t typemask) const
+{
+    out.clear();
+    if (_count == 0 || radius < 0 || accepted(typemask) == 0) return;
+    uint64_t r2 = (uint64_t)radius * (uint64_t)radius;
+    int32_t cx0 = std::max(cellOf(clampcoord((int64_t)x - radius)), _mincx);
+    int32_t cx1 = std::min(cellOf(clampcoord((int64_t)x + radius)), _maxcx);
+    int32_t cy0 = std::max(cellOf(clampcoord((int64_t)y - radius)), _mincy);
+    int32_t cy1 = std::min(cellOf(clampcoord((int64_t)y + radius)), _maxcy);
+    if (cx0 > cx1 || cy0 > cy1) return;
+    auto take = [&](const std::vector<Entry>& v){
+        for (const Entry& e : v){
+            int64_t dx = (int64_t)e.x - x, dy = (int64_t)e.y - y;
+            if (distance2(dx, dy) <= r2 && typeAccepted(typemask, e.type)) out.push_back(e);
+        }
+    };
+    // Retangulo maior que o mapa: percorre as celulas que existem.
+    uint64_t w = (uint64_t)((int64_t)cx1 - cx0 + 1), h = (uint64_t)((int64_t)cy1 - cy0 + 1);
+    if (w > _cells.size() / h){
+        for (const auto& c : _cells){
+            int32_t cx = keyx(c.first), cy = keyy(c.first);
+            if (cx >= cx0 && cx <= cx1 && cy >= cy0 && cy <= cy1) take(c.second);
+        }
+        return;
+    }
+    for (int64_t cx = cx0; cx <= cx1; cx++){ // int64: cx1 pode ser INT32_MAX
+        for (int64_t cy = cy0; cy <= cy1; cy++){
+            const std::vector<Entry>* v = cell((int32_t)cx, (int32_t)cy);
+            if (v != nullptr) take(*v);
+        }
+    }
+}
+
+void SpatialIndex::scan(int64_t cx, int64_t cy, int32_t x, int32_t y, uint32_t typemask, Handle& best, uint64_t& bestd2) const
+{
+    if (cx < _mincx || cx > _maxcx || cy < _mincy || cy > _maxcy) return;
+    const std::vector<Entry>* v = cell((int32_t)cx, (int32_t)cy);
+    if (v != nullptr) scan(*v, x, y, typemask, best, bestd2);
+}
+
+void SpatialIndex::scan(const std::vector<Entry>& v, int32_t x, int32_t y, uint32_t typemask, Handle& best, uint64_t& bestd2) const
+{
+    for (const Entry& e : v){
+        if (!typeAccepted(typemask, e.type)) continue;
+        uint64_t d2 = distance2((int64_t)e.x - x, (int64_t)e.y - y);
+        if (best == NullHandle || d2 < bestd2){
+            bestd2 = d2;
+            best = e.handle;
+        }
+    }
+}
+
+// Busca em aneis de celulas em volta do ponto. Para quando o anel seguinte
+// ja esta mais longe que o melhor candidato encontrado; se os aneis ja
+// cobrem mais celulas do que o mapa tem (mundo esparso, tipo raro), termina
+// varrendo as celulas do mapa.
+Handle SpatialIndex::nearest(int32_t x, int32_t y, uint32_t typemask) const
+{
+    if (accepted(typemask) == 0) return NullHandle;
+    // Em int64: com celulas pequenas a distancia em celulas passa do int32.
+    int64_t cx = cellOf(x), cy = cellOf(y);
+    int64_t maxring = std::max(std::max(std::abs(cx - _mincx), std::abs(cx - _maxcx)),
+                               std::max(std::abs(cy - _mincy), std::abs(cy - _maxcy)));
+    Handle best = NullHandle;
+    uint64_t bestd2 = UINT64_MAX;
+
+    for (int64_t ring = 0; ring <= maxring; ring++){
+        // Qualquer ponto no anel "ring" esta a pelo menos (ring - 1) celulas.
+        int64_t mind = (ring - 1) * _cellsize;
+        if (best != NullHandle && mind > 0 && (uint64_t)mind > bestd2 / (uint64_t)mind) break; // mind^2 > bestd2
+        // Aneis 0..ring cobrem (2 ring + 1)^2 celulas.
+        if ((uint64_t)(2 * ring + 1) > _cells.size() / (uint64_t)(2 * ring + 1)){
+            for (const auto& c : _cells) scan(c.second, x, y, typemask, best, bestd2);
+            break;
+        }
+        // So a borda do anel: linhas de cima e de baixo inteiras, colunas
+        // da esquerda e da direita sem os cantos.
+        for (int64_t k = -ring; k <= ring; k++){
+            scan(cx + k, cy - ring, x, y, typemask, best, bestd2);
+            if (ring > 0) scan(cx + k, cy + ring, x, y, typemask, best, bestd2);
+        }
+        for (int64_t k = -ring + 1; k <= ring - 1; k++){
+            scan(cx - ring, cy + k, x, y, typemask, best, bestd2);
+            scan(cx + ring, cy + k, x, y, typemask, best, bestd2);
+        }
+    }
+    return best;
+}
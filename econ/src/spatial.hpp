@@ -0,0 +1,61 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "slotmap.hpp"
+
+using namespace std;
+
+// Grade uniforme sobre Building::_location. Cada celula de "cellsize" x
+// "cellsize" guarda os buildings que caem nela, assim as consultas olham so
+// as celulas perto do ponto em vez de todos os buildings. Celulas que
+// esvaziam ficam no mapa ate clear(), para criar e demolir nao alocar.
+//
+// Nenhuma consulta passa do custo de varrer as celulas do mapa: quando o
+// retangulo (within) ou os aneis (nearest) cobririam mais celulas do que o
+// mapa tem, elas percorrem o mapa direto. Com um contador por tipo,
+// nearest() de um tipo que nao existe volta na hora.
+class SpatialIndex {
+    public:
+        struct Entry {
+            Handle handle;
+            int32_t x, y;
+            int32_t type;
+        };
+
+        explicit SpatialIndex(int32_t cellsize = 16);
+
+        void insert(Handle h, int32_t x, int32_t y, int32_t type);
+        bool remove(Handle h, int32_t x, int32_t y);
+        void clear(void);
+        size_t size(void) const { return _count; }
+
+        // Buildings a distancia <= radius de (x, y). "typemask" filtra por
+        // tipo: bit 1 << type (0 aceita todos).
+        void within(int32_t x, int32_t y, int32_t radius, std::vector<Entry>& out, uint32_t typemask = 0) const;
+        // Building mais proximo de (x, y) com o tipo em typemask; NullHandle se nao houver.
+        Handle nearest(int32_t x, int32_t y, uint32_t typemask = 0) const;
+
+    private:
+        int32_t _cellsize;
+        std::unordered_map<uint64_t, std::vector<Entry>> _cells;
+        size_t _count;
+        size_t _typecount[33];                  // por tipo 0..31; 32 = outros
+        int32_t _mincx, _mincy, _maxcx, _maxcy; // celulas ocupadas (limite da busca)
+
+        int32_t cellOf(int32_t v) const;
+        static uint64_t key(int32_t cx, int32_t cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+        static int32_t keyx(uint64_t k) { return (int32_t)(uint32_t)(k >> 32); }
+        static int32_t keyy(uint64_t k) { return (int32_t)(uint32_t)k; }
+        static size_t typeslot(int32_t type) { return type >= 0 && type < 32 ? (size_t)type : 32; }
+        size_t accepted(uint32_t typemask) const;
+        const std::vector<Entry>* cell(int32_t cx, int32_t cy) const;
+        void scan(int64_t cx, int64_t cy, int32_t x, int32_t y, uint32_t typemask, Handle& best, uint64_t& bestd2) const;
+        void scan(const std::vector<Entry>& v, int32_t x, int32_t y, uint32_t typemask, Handle& best, uint64_t& bestd2) const;
+};
+
+inline bool typeAccepted(uint32_t typemask, int32_t type)
+{
+    return typemask == 0 || (type >= 0 && type < 32 && (typemask & (1u << type)) != 0);
+}
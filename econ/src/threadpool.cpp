@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cassert>
+#include "threadpool.hpp"
+
+ThreadPool::ThreadPool(size_t nthreads)
+{
+    if (nthreads == 0) nthreads = std::thread::hardware_concurrency();
+    if (nthreads == 0) nthreads = 1;
+    _fn = nullptr;
+    _generation = 0;
+    _pending = 0;
+    _running = false;
+    _stop = false;
+    for (size_t i = 0; i < nthreads; i++){
+        _queues.push_back(new WorkQueue());
+    }
+    for (size_t i = 1; i < nthreads; i++){
+        _threads.emplace_back(&ThreadPool::loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_m);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for (std::thread& t : _threads) t.join();
+    for (WorkQueue* q : _queues) delete q;
+}
+
+// Pega da propria fila (fim) ou rouba de outra (inicio).
+bool ThreadPool::next(size_t worker, Range& r)
+{
+    {
+        WorkQueue& own = *_queues[worker];
+        std::lock_guard<std::mutex> lock(own.m);
+        if (!own.q.empty()){
+            r = own.q.back();
+            own.q.pop_back();
+            return true;
+        }
+    }
+    for (size_t k = 1; k < _queues.size(); k++){
+        WorkQueue& victim = *_queues[(worker + k) % _queues.size()];
+        std::lock_guard<std::mutex> lock(victim.m);
+        if (!victim.q.empty()){
+            r = victim.q.front();
+            victim.q.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::drain(size_t worker)
+{
+    Range r;
+    while (next(worker, r)){
+        (*_fn)(r.begin, r.end, worker);
+        if (_pending.fetch_sub(1, std::memory_order_acq_rel) == 1){
+            std::lock_guard<std::mutex> lock(_m);
+            _done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::loop(size_t worker)
+{
+    uint64_t seen = 0;
+    while (true){
+        {
+            std::unique_lock<std::mutex> lock(_m);
+            _wake.wait(lock, [&]{ return _stop || _generation != seen; });
+            if (_stop) return;
+            seen = _generation;
+        }
+        drain(worker);
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, size_t grain, const RangeFn& fn)
+{
+    if (n == 0) return;
+    if (grain == 0) grain = 1;
+    bool nested = _running.exchange(true, std::memory_order_acquire);
+    assert(!nested && "ThreadPool::parallelFor nao e reentrante");
+    (void)nested;
+    size_t nchunks = (n + grain - 1) / grain;
+    if (_queues.size() == 1 || nchunks == 1){
+        fn(0, n, 0);
+        _running.store(false, std::memory_order_release);
+        return;
+    }
+
+    // _fn e _pending sao publicados antes das filas receberem pedacos: um
+    // worker atrasado do job anterior so enxerga pedacos novos junto com o
+    // _fn novo.
+    {
+        std::lock_guard<std::mutex> lock(_m);
+        _fn = &fn;
+        _pending = nchunks;
+    }
+    // Pedacos consecutivos vao para o mesmo worker, para manter localidade.
+    size_t perqueue = (nchunks + _queues.size() - 1) / _queues.size();
+    for (size_t c = 0; c < nchunks; c++){
+        WorkQueue& q = *_queues[c / perqueue];
+        std::lock_guard<std::mutex> lock(q.m);
+        q.q.push_back(Range{c * grain, std::min(n, (c + 1) * grain)});
+    }
+    {
+        std::lock_guard<std::mutex> lock(_m);
+        _generation++;
+    }
+    _wake.notify_all();
+
+    drain(0);
+    std::unique_lock<std::mutex> lock(_m);
+    _done.wait(lock, [&]{ return _pending.load(std::memory_order_acquire) == 0; });
+    _fn = nullptr;
+    _running.store(false, std::memory_order_release);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+// Pool de threads com roubo de trabalho. parallelFor() corta [0, n) em
+// pedacos de "grain" itens e distribui entre as filas dos workers; quem
+// esvazia a propria fila rouba do inicio da fila dos outros. A thread que
+// chama parallelFor() trabalha como worker 0 ate o fim do job.
+//
+// parallelFor() nao e reentrante: um job por vez, chamado de uma thread so,
+// e nunca de dentro de fn (as duas chamadas seriam o worker 0). Chamadas
+// aninhadas disparam assert.
+class ThreadPool {
+    public:
+        // begin, end e indice do worker que executa o pedaco.
+        typedef std::function<void(size_t, size_t, size_t)> RangeFn;
+
+        explicit ThreadPool(size_t nthreads = 0);
+        ~ThreadPool(void);
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size(void) const { return _queues.size(); }
+        void parallelFor(size_t n, size_t grain, const RangeFn& fn);
+
+    private:
+        struct Range { size_t begin, end; };
+        struct WorkQueue {
+            std::mutex m;
+            std::deque<Range> q;
+        };
+
+        std::vector<WorkQueue*> _queues;
+        std::vector<std::thread> _threads;
+        std::mutex _m;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        const RangeFn* _fn;
+        uint64_t _generation;    // muda a cada job, acorda os workers
+        std::atomic<size_t> _pending;
+        std::atomic<bool> _running; // parallelFor em curso
+        bool _stop;
+
+        bool next(size_t worker, Range& r);
+        void drain(size_t worker);
+        void loop(size_t worker);
+};
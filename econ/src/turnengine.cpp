@@ -0,0 +1,460 @@
+#include <algorithm>
+#include "turnengine.hpp"
+#include "profiler.hpp"
+
+namespace {
+    // Valores iniciais por tipo: 1 produtor, 2 consumidor, 3 ambos.
+    struct TypeDefaults { int32_t production, demand, price, cost; };
+    const TypeDefaults typedefaults[4] = {
+        { 0,  0, 0,  0},
+        {10,  0, 0,  4},
+        { 0,  8, 3,  6},
+        {10,  8, 3, 10},
+    };
+
+    // Building estavel vende min(producao, demanda) todo turno: ou produz
+    // ao menos a demanda, ou ja vendeu todo o estoque.
+    inline int32_t steadyIncome(int32_t production, int32_t demand, int32_t price, int32_t cost)
+    {
+        return (production < demand ? production : demand) * price - cost;
+    }
+
+    inline int32_t steadyRate(int32_t production, int32_t demand)
+    {
+        return production > demand ? production - demand : 0;
+    }
+
+    // O income guardado tambem tem que ser o do regime, senao o turno em
+    // que o estoque zerou ficaria como resultado de todos os seguintes.
+    inline bool isSteady(int32_t stock, int32_t production, int32_t demand, int32_t price, int32_t cost, int32_t income)
+    {
+        if (stock < 0 || (production < demand && stock != 0)) return false;
+        return income == steadyIncome(production, demand, price, cost);
+    }
+
+    // Fila maior que 1/32 dos buildings: o laco cheio sai mais barato que
+    // as escritas fora de ordem da fila (medido no bench/dirtybench.cpp).
+    const size_t queuedivisor = 32;
+
+    template <typename C>
+    void swapRemove(C& column, size_t slot){
+        column.write(slot) = column.back();
+        column.pop_back();
+    }
+}
+
+TurnEngine::TurnEngine(void)
+{
+    _turn = 0;
+    _queuedtotal = 0;
+    _changes = 0;
+    _touched = 0;
+    _companiestouched = 0;
+    _settled = false;
+    _incremental = true;
+}
+
+// Os parciais por worker sao rascunho do turno e nao vao para a copia.
+TurnEngine::TurnEngine(const TurnEngine& o)
+    : _cols(o._cols), _since(o._since), _queued(o._queued), _pending(o._pending),
+      _steadydelta(o._steadydelta), _cashdelta(o._cashdelta), _turn(o._turn),
+      _queuedtotal(o._queuedtotal), _changes(o._changes), _touched(o._touched), _companiestouched(o._companiestouched),
+      _settled(o._settled), _incremental(o._incremental)
+{
+}
+
+size_t TurnEngine::addBuilding(int type, int owner)
+{
+    const TypeDefaults& d = typedefaults[(type >= 1 && type <= 3) ? type : 0];
+    _cols.production.push_back(d.production);
+    _cols.demand.push_back(d.demand);
+    _cols.stock.push_back(0);
+    _cols.price.push_back(d.price);
+    _cols.cost.push_back(d.cost);
+    _cols.owner.push_back(owner);
+    _cols.income.push_back(0);
+    _since.push_back((uint32_t)_turn);
+    _queued.push_back(_settled ? 1 : 0);
+    size_t slot = _cols.stock.size() - 1;
+    if (_settled){
+        if (_pending.size() <= slot / Column::chunksize) _pending.emplace_back();
+        _pending[slot / Column::chunksize].push_back((uint16_t)(slot % Column::chunksize));
+        _queuedtotal++;
+    }
+    return slot;
+}
+
+// Remove trocando com o ultimo slot, igual ao SlotMap, para as colunas
+// continuarem alinhadas com o indice denso do registro. Os dois saem da
+// soma dos estaveis; o que mudou de slot vai para a fila no lugar novo.
+void TurnEngine::removeBuilding(size_t slot)
+{
+    size_t last = size() - 1;
+    enqueue(slot);
+    enqueue(last);
+    if (_settled) _queuedtotal--; // a posicao de last fica velha na fila
+    swapRemove(_cols.production, slot);
+    swapRemove(_cols.demand, slot);
+    swapRemove(_cols.stock, slot);
+    swapRemove(_cols.price, slot);
+    swapRemove(_cols.cost, slot);
+    swapRemove(_cols.owner, slot);
+    swapRemove(_cols.income, slot);
+    swapRemove(_since, slot);
+    swapRemove(_queued, slot);
+    if (_settled && _pending.size() > _since.nchunks()) _pending.pop_back();
+}
+
+void TurnEngine::clear(void)
+{
+    _cols = BuildingColumns();
+    _since.clear();
+    _queued.clear();
+    _pending.clear();
+    _steadydelta.clear();
+    _cashdelta.clear();
+    _workerdelta.clear();
+    _turn = 0;
+    _queuedtotal = 0;
+    _changes = 0;
+    _touched = 0;
+    _companiestouched = 0;
+    _settled = false;
+}
+
+// Copia as colunas inteiras de uma vez (por exemplo, direto do mmap de um
+// snapshot).
+void TurnEngine::restore(size_t n, const int32_t* production, const int32_t* demand,
+                         const int32_t* stock, const int32_t* price, const int32_t* cost,
+                         const int32_t* owner, uint64_t turn)
+{
+    _cols.production.assign(production, n);
+    _cols.demand.assign(demand, n);
+    _cols.stock.assign(stock, n);
+    _cols.price.assign(price, n);
+    _cols.cost.assign(cost, n);
+    _cols.owner.assign(owner, n);
+    restored(n, turn);
+}
+
+void TurnEngine::restore(const std::shared_ptr<void>& memory, size_t n, int32_t* production, int32_t* demand,
+                         int32_t* stock, int32_t* price, int32_t* cost, int32_t* owner, uint64_t turn)
+{
+    _cols.production.share(memory, production, n);
+    _cols.demand.share(memory, demand, n);
+    _cols.stock.share(memory, stock, n);
+    _cols.price.share(memory, price, n);
+    _cols.cost.share(memory, cost, n);
+    _cols.owner.share(memory, owner, n);
+    restored(n, turn);
+}
+
+// O que nao vem do snapshot: renda zerada e tudo a reclassificar.
+void TurnEngine::restored(size_t n, uint64_t turn)
+{
+    _cols.income.assign(n, 0);
+    _since.assign(n, (uint32_t)turn);
+    _queued.assign(n, 0);
+    _cashdelta.clear();
+    _turn = turn;
+    _settled = false;
+}
+
+// Leva o estoque guardado de um building estavel ate o turno atual.
+void TurnEngine::materialize(size_t slot)
+{
+    uint32_t k = (uint32_t)_turn - _since[slot];
+    if (k == 0) return;
+    uint32_t rate = (uint32_t)steadyRate(_cols.production[slot], _cols.demand[slot]);
+    if (rate != 0) _cols.stock.write(slot) = (int32_t)((uint32_t)_cols.stock[slot] + k * rate);
+    _since.write(slot) = (uint32_t)_turn;
+}
+
+// Tira o building da soma dos estaveis e poe na fila do proximo turno.
+// Sem classificacao (_settled false) nao ha nada a fazer: settle() refaz.
+void TurnEngine::enqueue(size_t slot)
+{
+    if (!_settled) return;
+    if (_queuedtotal > size() / queuedivisor){ drop(); return; }
+    uint8_t q = _queued[slot];
+    if (q == 1) return;
+    materialize(slot);
+    _steadydelta[_cols.owner[slot]] -= _cols.income[slot];
+    _queued.write(slot) = 1;
+    if (q == 0){
+        _pending[slot / Column::chunksize].push_back((uint16_t)(slot % Column::chunksize));
+        _queuedtotal++;
+    }
+}
+
+// Preco e custo nao mudam o rate: o building so entra na fila (2) e o
+// resto do enqueue() fica para o turno, quando o pedaco dele ja esta no
+// cache. Aqui so uma escrita fora de ordem em vez de varias.
+void TurnEngine::touch(size_t slot)
+{
+    if (!_settled || _queued[slot] != 0) return;
+    if (_queuedtotal > size() / queuedivisor){ drop(); return; }
+    _queued.write(slot) = 2;
+    _pending[slot / Column::chunksize].push_back((uint16_t)(slot % Column::chunksize));
+    _queuedtotal++;
+}
+
+// Fila grande demais: leva os estoques ate o turno atual e larga a
+// classificacao. O resto do turno so escreve nas colunas e run() faz o
+// laco cheio, que reclassifica tudo.
+void TurnEngine::drop(void)
+{
+    sync();
+    _settled = false;
+}
+
+// Turno de um unico building (mesma regra do laco em run()).
+void TurnEngine::produce(size_t slot)
+{
+    enqueue(slot);
+    int32_t avail = _cols.stock[slot] + _cols.production[slot];
+    int32_t sold = std::min(avail, _cols.demand[slot]);
+    _cols.stock.write(slot) = avail - sold;
+    _cols.income.write(slot) = sold * _cols.price[slot] - _cols.cost[slot];
+}
+
+void TurnEngine::set(BuildingField field, size_t slot, int32_t value)
+{
+    _changes++;
+    if (field == FieldPrice || field == FieldCost) touch(slot);
+    else enqueue(slot);
+    switch (field){
+        case FieldProduction: _cols.production.write(slot) = value; break;
+        case FieldDemand:     _cols.demand.write(slot) = value; break;
+        case FieldStock:      _cols.stock.write(slot) = value; break;
+        case FieldPrice:      _cols.price.write(slot) = value; break;
+        case FieldCost:       _cols.cost.write(slot) = value; break;
+        case FieldOwner:      _cols.owner.write(slot) = value; break;
+    }
+}
+
+int32_t TurnEngine::stockAt(size_t slot) const
+{
+    if (!_settled) return _cols.stock[slot];
+    uint32_t k = (uint32_t)_turn - _since[slot];
+    uint32_t rate = (uint32_t)steadyRate(_cols.production[slot], _cols.demand[slot]);
+    return (int32_t)((uint32_t)_cols.stock[slot] + k * rate);
+}
+
+void TurnEngine::sync(void)
+{
+    if (!_settled) return;
+    const size_t n = size();
+    const uint32_t turn = (uint32_t)_turn;
+    for (size_t c = 0; c < _since.nchunks(); c++){
+        size_t m = std::min(n - c * Column::chunksize, Column::chunksize);
+        const uint32_t* since = _since.chunk(c);
+        size_t i = 0;
+        while (i < m && since[i] == turn) i++;
+        if (i == m) continue; // pedaco ja em dia: nao escreve (nem copia)
+        int32_t* stock = _cols.stock.writechunk(c);
+        uint32_t* sincew = _since.writechunk(c);
+        const int32_t* production = _cols.production.chunk(c);
+        const int32_t* demand = _cols.demand.chunk(c);
+        for (i = 0; i < m; i++){
+            uint32_t rate = (uint32_t)steadyRate(production[i], demand[i]);
+            stock[i] = (int32_t)((uint32_t)stock[i] + (turn - sincew[i]) * rate);
+            sincew[i] = turn;
+        }
+    }
+}
+
+// Classifica todos os buildings: estaveis vao para _steadydelta, o resto
+// para a fila. O(n), so depois de restore/turno cheio.
+void TurnEngine::settle(size_t ncompanies)
+{
+    const size_t n = size();
+    _since.assign(n, (uint32_t)_turn);
+    _queued.assign(n, 0);
+    _pending.assign(_since.nchunks(), std::vector<uint16_t>());
+    _steadydelta.assign(ncompanies, 0);
+    _queuedtotal = 0;
+    for (size_t c = 0; c < _pending.size(); c++){
+        size_t m = std::min(n - c * Column::chunksize, Column::chunksize);
+        uint8_t* queued = _queued.writechunk(c);
+        const int32_t* stock = _cols.stock.chunk(c);
+        const int32_t* production = _cols.production.chunk(c);
+        const int32_t* demand = _cols.demand.chunk(c);
+        const int32_t* price = _cols.price.chunk(c);
+        const int32_t* cost = _cols.cost.chunk(c);
+        const int32_t* owner = _cols.owner.chunk(c);
+        const int32_t* income = _cols.income.chunk(c);
+        for (size_t i = 0; i < m; i++){
+            if (isSteady(stock[i], production[i], demand[i], price[i], cost[i], income[i])){
+                _steadydelta[owner[i]] += income[i];
+            } else {
+                queued[i] = 1;
+                _pending[c].push_back((uint16_t)i);
+            }
+        }
+        _queuedtotal += _pending[c].size();
+    }
+    _settled = true;
+}
+
+// Passo 1: producao, vendas e resultado de cada building, sem desvios.
+// Anda pedaco por pedaco das colunas; os pedacos paralelos (grain) ja sao
+// um pedaco cada.
+void TurnEngine::step(size_t begin, size_t end)
+{
+    while (begin < end){
+        size_t c = begin / Column::chunksize, off = begin % Column::chunksize;
+        size_t n = std::min(end - begin, Column::chunksize - off);
+        int32_t* stock = _cols.stock.writechunk(c) + off;
+        const int32_t* production = _cols.production.chunk(c) + off;
+        const int32_t* demand = _cols.demand.chunk(c) + off;
+        const int32_t* price = _cols.price.chunk(c) + off;
+        const int32_t* cost = _cols.cost.chunk(c) + off;
+        int32_t* income = _cols.income.writechunk(c) + off;
+
+        for (size_t i = 0; i < n; i++){
+            int32_t avail = stock[i] + production[i];
+            int32_t sold = avail < demand[i] ? avail : demand[i];
+            stock[i] = avail - sold;
+            income[i] = sold * price[i] - cost[i];
+        }
+        begin += n;
+    }
+}
+
+// Passo 2: soma o resultado de cada building no caixa da sua company.
+void TurnEngine::accumulate(size_t begin, size_t end, int64_t* delta) const
+{
+    while (begin < end){
+        size_t c = begin / Column::chunksize, off = begin % Column::chunksize;
+        size_t n = std::min(end - begin, Column::chunksize - off);
+        const int32_t* owner = _cols.owner.chunk(c) + off;
+        const int32_t* income = _cols.income.chunk(c) + off;
+        for (size_t i = 0; i < n; i++){
+            delta[owner[i]] += income[i];
+        }
+        begin += n;
+    }
+}
+
+// Fila pequena: so os buildings na fila, pedaco por pedaco (a fila de um
+// pedaco cabe no cache junto com ele). Os estaveis entram no caixa pela
+// soma em _steadydelta.
+void TurnEngine::runIncremental(size_t ncompanies)
+{
+    if (_steadydelta.size() < ncompanies) _steadydelta.resize(ncompanies, 0);
+    _cashdelta.assign(_steadydelta.begin(), _steadydelta.begin() + ncompanies);
+    _companymark.assign(ncompanies, 0);
+    _touched = 0;
+    _companiestouched = 0;
+
+    const size_t n = size();
+    const uint32_t next = (uint32_t)(_turn + 1);
+    for (size_t c = 0; c < _pending.size(); c++){
+        if (_pending[c].empty()) continue;
+        size_t m = std::min(n - c * Column::chunksize, Column::chunksize);
+        // Fila do pedaco em ordem de slot (um bit por posicao): o laco anda
+        // para frente nas colunas, sem saltos aleatorios, e sem repetidos.
+        _bits.assign(Column::chunksize / 64, 0);
+        for (uint16_t i : _pending[c]) _bits[i >> 6] |= (uint64_t)1 << (i & 63);
+        _pending[c].clear();
+        _work.clear();
+        for (size_t w = 0; w < _bits.size(); w++){
+            for (uint64_t b = _bits[w]; b != 0; b &= b - 1){
+                _work.push_back((uint16_t)(w * 64 + (size_t)__builtin_ctzll(b)));
+            }
+        }
+        uint8_t* queued = _queued.writechunk(c);
+        int32_t* stock = _cols.stock.writechunk(c);
+        int32_t* income = _cols.income.writechunk(c);
+        uint32_t* since = _since.writechunk(c);
+        const int32_t* production = _cols.production.chunk(c);
+        const int32_t* demand = _cols.demand.chunk(c);
+        const int32_t* price = _cols.price.chunk(c);
+        const int32_t* cost = _cols.cost.chunk(c);
+        const int32_t* owner = _cols.owner.chunk(c);
+        for (uint16_t i : _work){
+            if (i >= m || !queued[i]) continue; // posicao velha
+            int32_t o = owner[i];
+            if (queued[i] == 2){ // resto do enqueue() adiado por touch()
+                uint32_t rate = (uint32_t)steadyRate(production[i], demand[i]);
+                stock[i] = (int32_t)((uint32_t)stock[i] + (next - 1 - since[i]) * rate);
+                _steadydelta[o] -= income[i];
+                _cashdelta[o] -= income[i]; // ja copiado de _steadydelta acima
+            }
+            queued[i] = 0;
+            int32_t avail = stock[i] + production[i];
+            int32_t sold = avail < demand[i] ? avail : demand[i];
+            stock[i] = avail - sold;
+            income[i] = sold * price[i] - cost[i];
+            since[i] = next;
+            _cashdelta[o] += income[i];
+            _companiestouched += 1 - _companymark[o];
+            _companymark[o] = 1;
+            _touched++;
+            if (isSteady(stock[i], production[i], demand[i], price[i], cost[i], income[i])){
+                _steadydelta[o] += income[i];
+                _queuedtotal--;
+            } else {
+                _pending[c].push_back(i);
+            }
+        }
+        for (uint16_t i : _pending[c]) queued[i] = 1;
+    }
+    _turn++;
+}
+
+void TurnEngine::runFull(size_t ncompanies, ThreadPool* pool)
+{
+    const size_t n = _cols.stock.size();
+    sync();
+    _cashdelta.assign(ncompanies, 0);
+    _touched = n;
+    _companiestouched = ncompanies;
+    _settled = false;
+    // Tabelas exclusivas antes dos workers escreverem pedacos em paralelo.
+    _cols.stock.detach();
+    _cols.income.detach();
+
+    if (pool == nullptr || pool->size() == 1 || n <= grain){
+        step(0, n);
+        accumulate(0, n, _cashdelta.data());
+        _turn++;
+        return;
+    }
+
+    // Os pedacos cortam as companies grandes em varios pedacos; cada worker
+    // soma no seu proprio vetor de caixa, sem disputa.
+    _workerdelta.resize(pool->size());
+    for (std::vector<int64_t>& d : _workerdelta) d.assign(ncompanies, 0);
+    pool->parallelFor(n, grain, [this](size_t begin, size_t end, size_t worker){
+        PROFILE_SCOPE("production.chunk");
+        step(begin, end);
+        accumulate(begin, end, _workerdelta[worker].data());
+    });
+
+    // Ponto de juncao: os parciais de cada worker viram o caixa de cada
+    // company. Somas inteiras, entao o resultado nao depende de quantas
+    // threads rodaram nem de quem roubou qual pedaco.
+    pool->parallelFor(ncompanies, 4096, [this](size_t begin, size_t end, size_t){
+        for (const std::vector<int64_t>& d : _workerdelta){
+            for (size_t c = begin; c < end; c++) _cashdelta[c] += d[c];
+        }
+    });
+    _turn++;
+}
+
+// Com a fila grande o laco cheio (vetorizado e em paralelo) sai mais
+// barato. Depois dele tudo so e reclassificado se o turno mudou pouco:
+// num mundo que muda muito settle() a cada turno custaria outro laco.
+void TurnEngine::run(size_t ncompanies, ThreadPool* pool)
+{
+    const size_t limit = size() / queuedivisor;
+    if (!_incremental || queued() > limit){
+        runFull(ncompanies, pool);
+        if (_incremental && _changes <= limit) settle(ncompanies);
+    } else {
+        runIncremental(ncompanies);
+    }
+    _changes = 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "threadpool.hpp"
+#include "cow.hpp"
+
+using namespace std;
+
+// Colunas (structure-of-arrays) de todos os buildings do mundo.
+// Cada building ocupa o mesmo indice ("slot") em todas as colunas, assim o
+// turno percorre vetores continuos em vez de seguir ponteiros Building*.
+// As colunas sao copy-on-write (cow.hpp): copiar BuildingColumns, ou o
+// TurnEngine inteiro, e O(1) e so os pedacos escritos depois sao copiados.
+typedef CowColumn<int32_t> Column;
+
+struct BuildingColumns {
+    Column production; // unidades produzidas por turno
+    Column demand;     // unidades vendidas por turno (maximo)
+    Column stock;      // estoque atual
+    Column price;      // preco de venda por unidade
+    Column cost;       // custo de manutencao por turno
+    Column owner;      // indice da company dona
+    Column income;     // resultado do ultimo turno (vendas - custo)
+};
+
+// Campos que podem mudar fora do turno (ver TurnEngine::set).
+enum BuildingField {
+    FieldProduction = 0, FieldDemand, FieldStock, FieldPrice, FieldCost, FieldOwner
+};
+
+// Turno incremental: um building "estavel" vende sempre o mesmo, entao seu
+// income nao muda e o estoque anda em linha reta (rate = producao - vendas,
+// >= 0). Esses ficam fora do laco: o income ja esta somado por company em
+// _steadydelta e o estoque guardado vale no turno _since, atualizado so
+// quando alguem le (stockAt, sync) ou muda o building. O turno recalcula so
+// os buildings na fila (_queued): os que mudaram (set, addBuilding...) e os
+// que ainda nao estabilizaram (estoque sendo vendido).
+//
+// Com mais de 1/32 dos buildings na fila (ou setIncremental(false)) roda o
+// laco cheio antigo, em paralelo, e so reclassifica tudo quando o turno
+// voltar a mudar pouco.
+class TurnEngine {
+    private:
+        BuildingColumns _cols;
+        CowColumn<uint32_t> _since;       // turno em que stock[slot] vale (estaveis)
+        CowColumn<uint8_t> _queued;       // 1: na fila; 2: na fila, enqueue() adiado (touch)
+        // Fila por pedaco das colunas: posicoes dentro do pedaco. Pode ter
+        // repetidos ou posicoes que ja sairam; _queued e quem vale.
+        std::vector<std::vector<uint16_t>> _pending;
+        std::vector<uint16_t> _work;
+        std::vector<uint64_t> _bits;
+        std::vector<int64_t> _steadydelta; // income dos estaveis, por company
+        std::vector<int64_t> _cashdelta; // variacao de caixa por company no turno
+        std::vector<std::vector<int64_t>> _workerdelta; // parciais por worker
+        std::vector<uint8_t> _companymark;
+        uint64_t _turn;
+        size_t _queuedtotal;
+        size_t _changes;          // set() desde o ultimo turno
+        size_t _touched;          // buildings recalculados no ultimo turno
+        size_t _companiestouched; // companies com algum building recalculado
+        bool _settled;            // false: _since/_queued/_steadydelta a refazer
+        bool _incremental;
+
+        void step(size_t begin, size_t end);
+        void accumulate(size_t begin, size_t end, int64_t* delta) const;
+        void runFull(size_t ncompanies, ThreadPool* pool);
+        void runIncremental(size_t ncompanies);
+        void settle(size_t ncompanies);
+        void materialize(size_t slot);
+        void enqueue(size_t slot);
+        void touch(size_t slot);
+        void drop(void);
+        void restored(size_t n, uint64_t turn);
+
+    public:
+        TurnEngine(void);
+        // Copia barata (ver BuildingColumns), usada pelos forks do mundo.
+        TurnEngine(const TurnEngine& o);
+        size_t addBuilding(int type, int owner);
+        void removeBuilding(size_t slot);
+        void produce(size_t slot);
+        // Muda um campo e poe o building na fila do proximo turno.
+        void set(BuildingField field, size_t slot, int32_t value);
+        static const size_t grain = Column::chunksize; // buildings por pedaco paralelo
+
+        void run(size_t ncompanies, ThreadPool* pool = nullptr);
+        void setIncremental(bool on) { _incremental = on; }
+        void clear(void);
+        void restore(size_t n, const int32_t* production, const int32_t* demand,
+                     const int32_t* stock, const int32_t* price, const int32_t* cost,
+                     const int32_t* owner, uint64_t turn);
+        // Igual, mas sem copiar: as colunas ficam na memoria de "memory"
+        // (ex.: o mmap privado de um SnapshotFile), ver CowColumn::share.
+        void restore(const std::shared_ptr<void>& memory, size_t n, int32_t* production, int32_t* demand,
+                     int32_t* stock, int32_t* price, int32_t* cost, int32_t* owner, uint64_t turn);
+        size_t size(void) const { return _cols.stock.size(); }
+        uint64_t turn(void) const { return _turn; }
+        int64_t cashdelta(size_t company) const { return _cashdelta[company]; }
+        size_t touched(void) const { return _touched; }
+        size_t companiestouched(void) const { return _companiestouched; }
+        size_t queued(void) const { return _settled ? _queuedtotal : size(); }
+
+        // Estoque atual de um building (o guardado pode estar atrasado).
+        int32_t stockAt(size_t slot) const;
+        // Atualiza a coluna de estoque inteira; chamar antes de ler
+        // columns().stock de tudo (snapshot, UI).
+        void sync(void);
+        const BuildingColumns& columns(void) const { return _cols; }
+};
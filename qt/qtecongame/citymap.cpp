@@ -0,0 +1,241 @@
+#include <QPainter>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <algorithm>
+#include <cmath>
+#include "citymap.h"
+
+namespace {
+    const QColor typecolor[CityMapWidget::ntypes] = {
+        QColor(128, 128, 128), // sem tipo
+        QColor(46, 139, 87),   // produtor
+        QColor(70, 110, 200),  // consumidor
+        QColor(210, 140, 40),  // ambos
+    };
+
+    int64_t floordiv(int64_t a, int64_t b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+    uint64_t cellkey(int64_t cx, int64_t cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+
+    // Celula sob a coordenada v do mapa (double da vista), presa a uma faixa
+    // que cobre o int32 com folga antes de virar inteiro.
+    int64_t cellat(double v)
+    {
+        double c = std::floor(v / CityMapWidget::cellsize);
+        return (int64_t)std::min(1e12, std::max(-1e12, c));
+    }
+}
+
+CityMapWidget::CityMapWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent); // o fundo e pintado aqui
+    setMinimumSize(200, 200);
+}
+
+// O snapshot muda a cada quadro, mas posicoes so mudam com o layout:
+// a grade so e refeita entao.
+void CityMapWidget::setSnapshot(const WorldSnapshot* snapshot)
+{
+    _world = snapshot;
+    if (snapshot->layout == _layout) return;
+    _layout = snapshot->layout;
+    rebuild();
+    if (!_fitted) fit();
+    update();
+}
+
+// Ordenacao por contagem: duas passadas sobre os buildings, sem alocar por
+// celula. So celulas com building entram, entao a grade tem no maximo n
+// celulas, por mais espalhado que o mundo esteja.
+void CityMapWidget::rebuild()
+{
+    const WorldSnapshot& w = *_world;
+    size_t n = w.size();
+    _cellindex.clear();
+    _cellx.clear();
+    _celly.clear();
+    _cellstart.clear();
+    _items.clear();
+    _celltypes.clear();
+    if (n == 0) return;
+
+    std::vector<uint32_t> cellof(n);
+    _cellstart.push_back(0);
+    for (size_t i = 0; i < n; i++){
+        int64_t cx = floordiv(w.x[i], cellsize), cy = floordiv(w.y[i], cellsize);
+        auto it = _cellindex.emplace(cellkey(cx, cy), (uint32_t)_cellx.size());
+        if (it.second){
+            _cellx.push_back(cx);
+            _celly.push_back(cy);
+            _cellstart.push_back(0);
+            _celltypes.resize(_celltypes.size() + ntypes, 0);
+        }
+        uint32_t c = it.first->second;
+        cellof[i] = c;
+        _cellstart[c + 1]++;
+        _celltypes[(size_t)c * ntypes + (uint32_t)w.type[i] % ntypes]++;
+    }
+    size_t ncells = _cellx.size();
+    for (size_t c = 0; c < ncells; c++) _cellstart[c + 1] += _cellstart[c];
+    _items.resize(n);
+    std::vector<uint32_t> fill(_cellstart.begin(), _cellstart.end() - 1);
+    for (size_t i = 0; i < n; i++) _items[fill[cellof[i]]++] = (uint32_t)i;
+
+    _mincx = *std::min_element(_cellx.begin(), _cellx.end());
+    _maxcx = *std::max_element(_cellx.begin(), _cellx.end());
+    _mincy = *std::min_element(_celly.begin(), _celly.end());
+    _maxcy = *std::max_element(_celly.begin(), _celly.end());
+}
+
+// Primeira vez com buildings: enquadra o mundo todo.
+void CityMapWidget::fit()
+{
+    if (_cellx.empty()) return;
+    double wx = (double)(_maxcx - _mincx + 1) * cellsize, wy = (double)(_maxcy - _mincy + 1) * cellsize;
+    _scale = std::min(width() / wx, height() / wy);
+    _origin = QPointF((double)_mincx * cellsize, (double)_mincy * cellsize);
+    _fitted = true;
+}
+
+// Chama fn(k, coluna, linha) para cada celula ocupada no retangulo. Se o
+// retangulo tem mais celulas do que as ocupadas, percorre as ocupadas.
+template <typename Fn>
+void CityMapWidget::visit(int64_t c0, int64_t r0, int64_t c1, int64_t r1, Fn fn) const
+{
+    if (c0 > c1 || r0 > r1 || _cellx.empty()) return;
+    uint64_t cols = (uint64_t)(c1 - c0 + 1), rows = (uint64_t)(r1 - r0 + 1);
+    if (cols > _cellx.size() / rows){
+        for (size_t k = 0; k < _cellx.size(); k++){
+            if (_cellx[k] >= c0 && _cellx[k] <= c1 && _celly[k] >= r0 && _celly[k] <= r1) fn(k, _cellx[k], _celly[k]);
+        }
+        return;
+    }
+    for (int64_t r = r0; r <= r1; r++){
+        for (int64_t c = c0; c <= c1; c++){
+            auto it = _cellindex.find(cellkey(c, r));
+            if (it != _cellindex.end()) fn(it->second, c, r);
+        }
+    }
+}
+
+void CityMapWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(24, 24, 28));
+    if (_world == nullptr || _cellx.empty()) return;
+
+    // Celulas que tocam a tela; o resto nem e visitado.
+    double x0 = _origin.x(), y0 = _origin.y();
+    double x1 = x0 + width() / _scale, y1 = y0 + height() / _scale;
+    int64_t c0 = std::max(_mincx, cellat(x0));
+    int64_t r0 = std::max(_mincy, cellat(y0));
+    int64_t c1 = std::min(_maxcx, cellat(x1));
+    int64_t r1 = std::min(_maxcy, cellat(y1));
+    if (c0 > c1 || r0 > r1) return;
+
+    if (_scale >= detailscale) paintDetail(painter, c0, r0, c1, r1);
+    else paintDensity(painter, c0, r0, c1, r1);
+}
+
+void CityMapWidget::paintDetail(QPainter& painter, int64_t c0, int64_t r0, int64_t c1, int64_t r1)
+{
+    const WorldSnapshot& w = *_world;
+    double side = std::max(1.0, _scale * 0.8);
+    for (int t = 0; t < ntypes; t++) _batch[t].clear();
+    visit(c0, r0, c1, r1, [&](size_t cell, int64_t, int64_t){
+        for (uint32_t k = _cellstart[cell]; k < _cellstart[cell + 1]; k++){
+            uint32_t i = _items[k];
+            _batch[(uint32_t)w.type[i] % ntypes].push_back(
+                QRectF((w.x[i] - _origin.x()) * _scale, (w.y[i] - _origin.y()) * _scale, side, side));
+        }
+    });
+    painter.setPen(Qt::NoPen);
+    for (int t = 0; t < ntypes; t++){
+        if (_batch[t].empty()) continue;
+        painter.setBrush(typecolor[t]);
+        painter.drawRects(_batch[t].data(), (int)_batch[t].size());
+    }
+}
+
+// Cada ladrilho junta k x k celulas, com k escolhido para o ladrilho ter
+// pelo menos tilepixels de lado. Cor do tipo mais comum; opacidade pela
+// quantidade relativa ao ladrilho mais cheio da tela. Ladrilhos tem pelo
+// menos tilepixels, entao sao no maximo o que cabe na tela.
+void CityMapWidget::paintDensity(QPainter& painter, int64_t c0, int64_t r0, int64_t c1, int64_t r1)
+{
+    int64_t k = (int64_t)std::min(1e12, std::max(1.0, std::ceil(tilepixels / (cellsize * _scale))));
+    c0 = floordiv(c0, k) * k;
+    r0 = floordiv(r0, k) * k;
+    int64_t tcols = (c1 - c0) / k + 1, trows = (r1 - r0) / k + 1;
+
+    std::vector<uint32_t>& counts = _tilecounts;
+    counts.assign((size_t)(tcols * trows * ntypes), 0);
+    visit(c0, r0, c1, r1, [&](size_t cell, int64_t c, int64_t r){
+        const uint32_t* src = &_celltypes[cell * ntypes];
+        uint32_t* dst = &counts[(size_t)(((r - r0) / k) * tcols + (c - c0) / k) * ntypes];
+        for (int t = 0; t < ntypes; t++) dst[t] += src[t];
+    });
+    uint32_t top = 1;
+    for (size_t i = 0; i < counts.size(); i += ntypes){
+        top = std::max(top, counts[i] + counts[i + 1] + counts[i + 2] + counts[i + 3]);
+    }
+
+    // bands faixas de opacidade por tipo: 32 lotes no maximo.
+    for (int t = 0; t < ntypes; t++){
+        for (int b = 0; b < bands; b++) _tiles[t][b].clear();
+    }
+    double tile = (double)k * cellsize * _scale;
+    for (int64_t tr = 0; tr < trows; tr++){
+        for (int64_t tc = 0; tc < tcols; tc++){
+            const uint32_t* ct = &counts[((size_t)tr * tcols + tc) * ntypes];
+            uint32_t total = ct[0] + ct[1] + ct[2] + ct[3];
+            if (total == 0) continue;
+            int best = (int)(std::max_element(ct, ct + ntypes) - ct);
+            int band = std::min(bands - 1, (int)((double)total / top * bands));
+            double mx = (double)(c0 + tc * k) * cellsize;
+            double my = (double)(r0 + tr * k) * cellsize;
+            _tiles[best][band].push_back(QRectF((mx - _origin.x()) * _scale, (my - _origin.y()) * _scale, tile, tile));
+        }
+    }
+    painter.setPen(Qt::NoPen);
+    for (int t = 0; t < ntypes; t++){
+        for (int b = 0; b < bands; b++){
+            if (_tiles[t][b].empty()) continue;
+            QColor color = typecolor[t];
+            color.setAlphaF(0.25 + 0.75 * (b + 1) / bands);
+            painter.setBrush(color);
+            painter.drawRects(_tiles[t][b].data(), (int)_tiles[t][b].size());
+        }
+    }
+}
+
+// Aproxima mantendo fixo o ponto do mapa sob o cursor.
+void CityMapWidget::wheelEvent(QWheelEvent *event)
+{
+    double factor = std::pow(1.0015, event->angleDelta().y());
+    QPointF pos = event->position();
+    QPointF anchor = _origin + pos / _scale;
+    _scale = std::min(256.0, std::max(0.001, _scale * factor));
+    _origin = anchor - pos / _scale;
+    update();
+}
+
+void CityMapWidget::mousePressEvent(QMouseEvent *event)
+{
+    _lastmouse = event->pos();
+}
+
+void CityMapWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!(event->buttons() & Qt::LeftButton)) return;
+    QPoint delta = event->pos() - _lastmouse;
+    _lastmouse = event->pos();
+    _origin -= QPointF(delta) / _scale;
+    update();
+}
+
+void CityMapWidget::resizeEvent(QResizeEvent *)
+{
+    if (!_fitted) fit();
+}
@@ -0,0 +1,76 @@
+#ifndef CITYMAP_H
+#define CITYMAP_H
+
+#include <QWidget>
+#include <QRectF>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "worldsnapshot.h"
+
+// Mapa da cidade: um quadrado por building na posicao (_location) do
+// snapshot. Arrastar move, roda do mouse aproxima.
+//
+// Os buildings ficam numa grade esparsa (celulas de cellsize unidades, so as
+// ocupadas, mesma ideia do SpatialIndex do nucleo) montada so quando o
+// layout muda; buildings longe um do outro nao criam celulas no meio. Ao
+// pintar, so as celulas visiveis sao percorridas (ou as ocupadas, se forem
+// menos) e os retangulos sao juntados por tipo: uma chamada drawRects por
+// tipo. Quando cada building teria menos de detailscale pixels, desenha
+// ladrilhos de densidade agregando celulas.
+class CityMapWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static const int cellsize = 16;       // unidades do mapa por celula
+    static const int ntypes = 4;          // tipos 0..3 (1 produtor, 2 consumidor, 3 ambos)
+    static constexpr double detailscale = 4.0; // px por unidade abaixo disso: densidade
+    static const int tilepixels = 8;      // lado minimo de um ladrilho de densidade
+
+    CityMapWidget(QWidget *parent = nullptr);
+    void setSnapshot(const WorldSnapshot* snapshot);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    const WorldSnapshot* _world = nullptr;
+    uint64_t _layout = 0;
+
+    // Grade em formato CSR sobre as celulas ocupadas: os buildings da
+    // celula ocupada k (coluna _cellx[k], linha _celly[k]) sao
+    // _items[_cellstart[k] .. _cellstart[k+1]). Coordenadas de celula em
+    // int64, para o mapa inteiro do int32 caber sem estouro.
+    int64_t _mincx = 0, _mincy = 0, _maxcx = 0, _maxcy = 0; // limites das ocupadas
+    std::unordered_map<uint64_t, uint32_t> _cellindex;      // (coluna, linha) -> k
+    std::vector<int64_t> _cellx, _celly;
+    std::vector<uint32_t> _cellstart;
+    std::vector<uint32_t> _items;
+    std::vector<uint32_t> _celltypes; // contagem por tipo, ntypes por celula
+
+    // Vista: tela = (mapa - _origin) * _scale
+    QPointF _origin;
+    double _scale = 4.0;
+    bool _fitted = false;
+    QPoint _lastmouse;
+
+    // Lotes por tipo (e faixa de densidade), reaproveitados entre pinturas.
+    static const int bands = 8;
+    std::vector<QRectF> _batch[ntypes];
+    std::vector<QRectF> _tiles[ntypes][bands];
+    std::vector<uint32_t> _tilecounts;
+
+    void rebuild();
+    void fit();
+    template <typename Fn>
+    void visit(int64_t c0, int64_t r0, int64_t c1, int64_t r1, Fn fn) const;
+    void paintDetail(QPainter& painter, int64_t c0, int64_t r0, int64_t c1, int64_t r1);
+    void paintDensity(QPainter& painter, int64_t c0, int64_t r0, int64_t c1, int64_t r1);
+};
+
+#endif // CITYMAP_H
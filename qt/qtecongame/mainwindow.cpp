@@ -1,5 +1,24 @@
 #include "mainwindow.h"
 
+namespace {
+    // Tabela para milhoes de linhas: altura fixa (a view calcula a posicao
+    // de cada linha sem medir nada) e sem cabecalho vertical.
+    QTableView* makeTable(QAbstractItemModel* model, QWidget* parent)
+    {
+        QTableView* view = new QTableView(parent);
+        view->setModel(model);
+        view->setSortingEnabled(true);
+        view->sortByColumn(-1, Qt::AscendingOrder); // comeca na ordem do registro
+        view->setSelectionBehavior(QAbstractItemView::SelectRows);
+        view->setWordWrap(false);
+        view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        view->verticalHeader()->setDefaultSectionSize(view->fontMetrics().height() + 4);
+        view->verticalHeader()->hide();
+        view->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+        return view;
+    }
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QWidget(parent)
 {
@@ -12,6 +31,21 @@ MainWindow::MainWindow(QWidget *parent)
     _caseCheckBox = new QCheckBox("I like This", this);
     _playButton = new QPushButton("Jogar", this);
     _closeButton = new QPushButton("Teste close button", this);
+    _populateButton = new QPushButton("Criar buildings", this);
+    _lineEdit->setPlaceholderText("quantidade de buildings");
+
+    _runButton = new QPushButton("Rodar", this);
+    _runButton->setCheckable(true);
+
+    _companyModel = new CompanyTableModel(this);
+    _buildingModel = new BuildingTableModel(this);
+    _tabs = new QTabWidget(this);
+    _companyView = makeTable(_companyModel, _tabs);
+    _buildingView = makeTable(_buildingModel, _tabs);
+    _tabs->addTab(_companyView, "Companies");
+    _tabs->addTab(_buildingView, "Buildings");
+    _map = new CityMapWidget(_tabs);
+    _tabs->addTab(_map, "Mapa");
 
 
     //Creating Layout
@@ -24,22 +58,62 @@ MainWindow::MainWindow(QWidget *parent)
     _vlayout->addLayout(sublayout);
     _hlayout->addWidget(_lineEdit);
     _hlayout->addWidget(_caseCheckBox);
+    _hlayout->addWidget(_populateButton);
     _hlayout->addWidget(_playButton);
+    _hlayout->addWidget(_runButton);
     _vlayout->addLayout(_hlayout);
+    _vlayout->addWidget(_tabs);
 
     connect(_closeButton, SIGNAL(clicked()),this,SLOT(close()));
     connect(_playButton, SIGNAL(clicked()),this,SLOT(playSlot()));
+    connect(_populateButton, SIGNAL(clicked()),this,SLOT(populateSlot()));
+
+    // Worker sem parent: e movido para _simthread e apagado quando ela termina.
+    _worker = new SimulationWorker();
+    _worker->moveToThread(&_simthread);
+    connect(&_simthread, SIGNAL(finished()), _worker, SLOT(deleteLater()));
+    connect(_runButton, SIGNAL(toggled(bool)), _worker, SLOT(setRunning(bool)));
+    _frame.setSingleShot(true);
+    _frame.setInterval(SimulationWorker::publishinterval);
+    connect(&_frame, SIGNAL(timeout()), this, SLOT(frameSlot()));
+    connect(_worker, &SimulationWorker::published, this, [this](){
+        if (!_frame.isActive()) _frame.start();
+    });
+    _simthread.start();
     this->setLayout(_vlayout);
     this->show();
 
 }
 
+// Comandos vao para a thread da simulacao como chamadas enfileiradas; o
+// resultado volta pelos snapshots.
 void MainWindow::playSlot(){
+    QMetaObject::invokeMethod(_worker, "runTurns", Qt::QueuedConnection, Q_ARG(int, 1));
+}
+
+// Cria a quantidade de buildings pedida em _lineEdit (1000 se vazio).
+void MainWindow::populateSlot(){
+    bool ok = false;
+    qlonglong n = _lineEdit->text().toLongLong(&ok);
+    if (!ok || n <= 0) n = 1000;
+    QMetaObject::invokeMethod(_worker, "populate", Qt::QueuedConnection, Q_ARG(qlonglong, n));
+}
 
+// Um refresh por quadro com o snapshot mais recente; os intermediarios
+// publicados enquanto isso sao pulados.
+void MainWindow::frameSlot(){
+    _worker->acknowledge();
+    TripleBuffer<WorldSnapshot>& snapshots = _worker->snapshots();
+    if (!snapshots.acquire()) return;
+    _companyModel->setSnapshot(&snapshots.front());
+    _buildingModel->setSnapshot(&snapshots.front());
+    _map->setSnapshot(&snapshots.front());
 }
 
 MainWindow::~MainWindow()
 {
+    _simthread.quit(); // turnos enfileirados sao descartados
+    _simthread.wait();
     //delete sublayout;
 }
 
@@ -4,6 +4,9 @@
 #include <QMainWindow>
 #include <QDialog>
 #include <QtWidgets>
+#include "simulationworker.h"
+#include "worldmodel.h"
+#include "citymap.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -19,6 +22,8 @@ public:
 
 public slots:
     void playSlot();
+    void populateSlot();
+    void frameSlot();
 
 signals:
     void startSignal();
@@ -32,6 +37,17 @@ private:
     QHBoxLayout     *_hlayout;
     QPushButton     *_playButton;
     QPushButton     *_closeButton;
+    QPushButton     *_populateButton;
+    QTabWidget      *_tabs;
+    QTableView      *_companyView;
+    QTableView      *_buildingView;
+    CityMapWidget   *_map;
+    QPushButton     *_runButton;
+    QThread             _simthread;   // a simulacao roda aqui, fora da thread da UI
+    SimulationWorker   *_worker;
+    QTimer              _frame;       // junta os published() num refresh por quadro
+    CompanyTableModel  *_companyModel;
+    BuildingTableModel *_buildingModel;
     Ui::MainWindow *ui;
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,103 @@
+#include <QMetaObject>
+#include <string>
+#include "simulationworker.h"
+
+SimulationWorker::SimulationWorker(QObject *parent)
+    : QObject(parent)
+{
+    _sincepublish.start();
+}
+
+// Cria n buildings numa grade, entre 10 companies (criadas na primeira vez).
+void SimulationWorker::populate(qlonglong n)
+{
+    if (n <= 0) return;
+    while (_manager.ncompanies() < 10){
+        _manager.criarCompany("Company " + std::to_string(_manager.ncompanies()));
+    }
+    size_t base = _manager.buildings().size();
+    for (qlonglong i = 0; i < n; i++){
+        size_t k = base + (size_t)i;
+        if (i % 100 == 0) _manager.selectCompany((int)(k / 100 % _manager.ncompanies()));
+        _manager.criabuilding(1 + (int)(k % 3), "predio", (int)(k % 1000), (int)(k / 1000));
+    }
+    _layout++;
+    publish(true);
+}
+
+void SimulationWorker::runTurns(int n)
+{
+    for (int i = 0; i < n; i++){
+        _manager.passarturno();
+        publish(false);
+    }
+    publish(true);
+}
+
+void SimulationWorker::setRunning(bool on)
+{
+    bool wasrunning = _running;
+    _running = on;
+    if (on && !wasrunning) QMetaObject::invokeMethod(this, "loop", Qt::QueuedConnection);
+    if (!on) publish(true);
+}
+
+// Um turno por volta do event loop: comandos da UI entram entre os turnos.
+void SimulationWorker::loop()
+{
+    if (!_running) return;
+    _manager.passarturno();
+    publish(false);
+    QMetaObject::invokeMethod(this, "loop", Qt::QueuedConnection);
+}
+
+void SimulationWorker::publish(bool force)
+{
+    if (!force && _sincepublish.elapsed() < publishinterval) return;
+    capture(_snapshots.back());
+    _snapshots.publish();
+    _sincepublish.restart();
+    if (!_signalled.exchange(true, std::memory_order_acq_rel)) emit published();
+}
+
+// O buffer de tras pode ser de dois publishes atras: a parte fixa so e
+// recopiada se o layout mudou desde entao.
+void SimulationWorker::capture(WorldSnapshot& s)
+{
+    const BuildingRegistry& registry = _manager.buildings();
+    _manager.sync(); // estoque dos buildings estaveis (turno incremental)
+    const BuildingColumns& cols = _manager.engine().columns();
+    size_t n = registry.size();
+
+    s.turn = _manager.engine().turn();
+    s.companies.resize(_manager.ncompanies());
+    for (size_t i = 0; i < s.companies.size(); i++){
+        Company* c = _manager.getcompany((int)i);
+        s.companies[i].name = c->nameSymbol();
+        s.companies[i].cash = c->getcash().cents;
+        s.companies[i].buildings = c->buildings().size();
+    }
+
+    if (s.layout != _layout){
+        s.id.resize(n);
+        s.name.resize(n);
+        s.type.resize(n);
+        s.x.resize(n);
+        s.y.resize(n);
+        for (size_t i = 0; i < n; i++){
+            Building* b = registry.at(i);
+            s.id[i] = b->uniqueID();
+            s.name[i] = b->nomeSymbol();
+            s.type[i] = b->type();
+            s.x[i] = b->posx();
+            s.y[i] = b->posy();
+        }
+        s.layout = _layout;
+    }
+    // O(1): so a tabela de pedacos e compartilhada.
+    s.owner = cols.owner;
+    s.production = cols.production;
+    s.stock = cols.stock;
+    s.price = cols.price;
+    s.income = cols.income;
+}
@@ -0,0 +1,52 @@
+#ifndef SIMULATIONWORKER_H
+#define SIMULATIONWORKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <atomic>
+#include "manager.hpp"
+#include "worldsnapshot.h"
+
+// Dono do Manager, vive numa QThread propria. A UI manda comandos por
+// chamadas enfileiradas (slots) e le o mundo so pelos snapshots; nunca
+// toca no Manager. Rodando sem parar, o worker publica um snapshot no
+// maximo a cada publishinterval ms; as colunas que mudam por turno entram
+// como copias COW, entao publicar nao copia o mundo.
+class SimulationWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int publishinterval = 16; // ms, um quadro a 60 Hz
+
+    SimulationWorker(QObject *parent = nullptr);
+    TripleBuffer<WorldSnapshot>& snapshots() { return _snapshots; }
+    // A UI chama antes de ler os snapshots: libera o proximo sinal published().
+    void acknowledge() { _signalled.store(false, std::memory_order_release); }
+
+public slots:
+    void populate(qlonglong n);
+    void runTurns(int n);
+    void setRunning(bool on);
+
+signals:
+    // Um snapshot novo esta pronto. Coalescido: nao e emitido de novo ate
+    // a UI chamar acknowledge(), assim a fila da UI nao cresce.
+    void published();
+
+private slots:
+    void loop();
+
+private:
+    Manager _manager;
+    TripleBuffer<WorldSnapshot> _snapshots;
+    std::atomic<bool> _signalled{false};
+    QElapsedTimer _sincepublish;
+    bool _running = false;
+    uint64_t _layout = 0;
+
+    void capture(WorldSnapshot& s);
+    void publish(bool force);
+};
+
+#endif // SIMULATIONWORKER_H
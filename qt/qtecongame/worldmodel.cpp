@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <numeric>
+#include "worldmodel.h"
+
+namespace {
+    // Ordena a permutacao pela chave; empate desempata pelo indice, assim a
+    // ordem nao muda de um turno para o outro quando as chaves sao iguais.
+    template <typename Key>
+    void sortby(std::vector<uint32_t>& order, size_t n, Qt::SortOrder dir, Key key)
+    {
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0u);
+        if (dir == Qt::AscendingOrder){
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){
+                const auto& ka = key(a);
+                const auto& kb = key(b);
+                return ka < kb || (!(kb < ka) && a < b);
+            });
+        } else {
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){
+                const auto& ka = key(a);
+                const auto& kb = key(b);
+                return kb < ka || (!(ka < kb) && a < b);
+            });
+        }
+    }
+
+    QString text(Symbol s)
+    {
+        std::string_view v = Interner::str(s);
+        return QString::fromUtf8(v.data(), (int)v.size());
+    }
+
+    // Onde cada indice persistente (selecao, item corrente) vai parar depois
+    // de reordenar: linha antiga -> indice denso -> linha nova.
+    QModelIndexList remap(const QAbstractItemModel* model, const QModelIndexList& from, size_t n,
+                          const std::vector<uint32_t>& before, const std::vector<uint32_t>& after)
+    {
+        std::vector<uint32_t> rowof;
+        if (!after.empty()){
+            rowof.resize(n);
+            for (uint32_t r = 0; r < after.size(); r++) rowof[after[r]] = r;
+        }
+        QModelIndexList to;
+        for (const QModelIndex& i : from){
+            size_t dense = before.empty() ? (size_t)i.row() : before[i.row()];
+            to.append(model->index(after.empty() ? (int)dense : (int)rowof[dense], i.column()));
+        }
+        return to;
+    }
+
+    // v: std::vector ou CowColumn
+    template <typename V>
+    void sortcolumn(std::vector<uint32_t>& order, Qt::SortOrder dir, const V& v)
+    {
+        sortby(order, v.size(), dir, [&](uint32_t i) -> decltype(v[0]) { return v[i]; });
+    }
+}
+
+// ---------------------------------------------------------------- companies
+
+CompanyTableModel::CompanyTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int CompanyTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _rows;
+}
+
+int CompanyTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColCount;
+}
+
+QVariant CompanyTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= _rows) return QVariant();
+    if (role == Qt::TextAlignmentRole && index.column() != ColName){
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole) return QVariant();
+
+    const WorldSnapshot::CompanyRow& company = _world->companies[companyAt(index.row())];
+    switch (index.column()){
+    case ColName:      return text(company.name);
+    case ColCash:      return QString::fromStdString(Money::fromCents(company.cash).str());
+    case ColBuildings: return (qulonglong)company.buildings;
+    }
+    return QVariant();
+}
+
+QVariant CompanyTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) return QVariant();
+    switch (section){
+    case ColName:      return tr("Company");
+    case ColCash:      return tr("Caixa");
+    case ColBuildings: return tr("Buildings");
+    }
+    return QVariant();
+}
+
+void CompanyTableModel::sort(int column, Qt::SortOrder order)
+{
+    _sortcolumn = column;
+    _sortorder = order;
+    emit layoutAboutToBeChanged();
+    QModelIndexList from = persistentIndexList();
+    _order.swap(_previous);
+    reorder();
+    if (!from.isEmpty()) changePersistentIndexList(from, remap(this, from, _rows, _previous, _order));
+    emit layoutChanged();
+}
+
+void CompanyTableModel::reorder()
+{
+    if (_world == nullptr){
+        _order.clear();
+        return;
+    }
+    const std::vector<WorldSnapshot::CompanyRow>& rows = _world->companies;
+    switch (_sortcolumn){
+    case ColName:
+        sortby(_order, rows.size(), _sortorder, [&](uint32_t i){ return Interner::str(rows[i].name); });
+        break;
+    case ColCash:
+        sortby(_order, rows.size(), _sortorder, [&](uint32_t i) -> const int64_t& { return rows[i].cash; });
+        break;
+    case ColBuildings:
+        sortby(_order, rows.size(), _sortorder, [&](uint32_t i) -> const size_t& { return rows[i].buildings; });
+        break;
+    default:
+        _order.clear();
+    }
+}
+
+// Poucas companies: reordena sempre.
+void CompanyTableModel::setSnapshot(const WorldSnapshot* snapshot)
+{
+    int rows = (int)snapshot->companies.size();
+    if (rows != _rows){
+        beginResetModel();
+        _world = snapshot;
+        _rows = rows;
+        reorder();
+        endResetModel();
+        return;
+    }
+    _world = snapshot;
+    if (_sortcolumn >= 0) sort(_sortcolumn, _sortorder);
+    if (_rows > 0) emit dataChanged(index(0, 0), index(_rows - 1, ColCount - 1));
+}
+
+// ---------------------------------------------------------------- buildings
+
+BuildingTableModel::BuildingTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    _sincesort.start();
+}
+
+int BuildingTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _rows;
+}
+
+int BuildingTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColCount;
+}
+
+QVariant BuildingTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= _rows) return QVariant();
+    if (role == Qt::TextAlignmentRole && index.column() != ColName){
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole) return QVariant();
+
+    const WorldSnapshot& w = *_world;
+    size_t i = denseAt(index.row());
+    switch (index.column()){
+    case ColID:         return (qulonglong)w.id[i];
+    case ColName:       return text(w.name[i]);
+    case ColType:       return w.type[i];
+    case ColX:          return w.x[i];
+    case ColY:          return w.y[i];
+    case ColOwner:      return w.owner[i];
+    case ColProduction: return w.production[i];
+    case ColStock:      return w.stock[i];
+    case ColPrice:      return w.price[i];
+    case ColIncome:     return w.income[i];
+    }
+    return QVariant();
+}
+
+QVariant BuildingTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) return QVariant();
+    switch (section){
+    case ColID:         return tr("ID");
+    case ColName:       return tr("Nome");
+    case ColType:       return tr("Tipo");
+    case ColX:          return tr("X");
+    case ColY:          return tr("Y");
+    case ColOwner:      return tr("Company");
+    case ColProduction: return tr("Producao");
+    case ColStock:      return tr("Estoque");
+    case ColPrice:      return tr("Preco");
+    case ColIncome:     return tr("Resultado");
+    }
+    return QVariant();
+}
+
+// O indice denso de uma linha so muda com o layout (e ai e reset), entao
+// selecao e item corrente seguem o building de uma ordem para a outra.
+void BuildingTableModel::sort(int column, Qt::SortOrder order)
+{
+    _sortcolumn = column;
+    _sortorder = order;
+    emit layoutAboutToBeChanged();
+    QModelIndexList from = persistentIndexList();
+    _order.swap(_previous);
+    reorder();
+    if (!from.isEmpty()) changePersistentIndexList(from, remap(this, from, _rows, _previous, _order));
+    emit layoutChanged();
+}
+
+// As colunas do snapshot sao vetores continuos no indice denso: ordenar 1M
+// linhas percorre um vetor de int32 por chave.
+void BuildingTableModel::reorder()
+{
+    _sincesort.restart();
+    if (_world == nullptr){
+        _order.clear();
+        return;
+    }
+    const WorldSnapshot& w = *_world;
+    switch (_sortcolumn){
+    case ColID:         sortcolumn(_order, _sortorder, w.id); break;
+    case ColName:
+        sortby(_order, w.size(), _sortorder, [&](uint32_t i){ return Interner::str(w.name[i]); });
+        break;
+    case ColType:       sortcolumn(_order, _sortorder, w.type); break;
+    case ColX:          sortcolumn(_order, _sortorder, w.x); break;
+    case ColY:          sortcolumn(_order, _sortorder, w.y); break;
+    case ColOwner:      sortcolumn(_order, _sortorder, w.owner); break;
+    case ColProduction: sortcolumn(_order, _sortorder, w.production); break;
+    case ColStock:      sortcolumn(_order, _sortorder, w.stock); break;
+    case ColPrice:      sortcolumn(_order, _sortorder, w.price); break;
+    case ColIncome:     sortcolumn(_order, _sortorder, w.income); break;
+    default:
+        _order.clear();
+    }
+}
+
+// Buildings criados ou demolidos: reset. Senao so avisa que os valores
+// mudaram; a view repinta apenas as linhas visiveis. Colunas fixas (ID ate
+// Company) so reordenam quando o layout muda; as que mudam a cada turno no
+// maximo a cada resortinterval ms, para a UI nao gastar o quadro ordenando.
+void BuildingTableModel::setSnapshot(const WorldSnapshot* snapshot)
+{
+    if (snapshot->layout != _layout || (int)snapshot->size() != _rows){
+        beginResetModel();
+        _world = snapshot;
+        _rows = (int)snapshot->size();
+        _layout = snapshot->layout;
+        reorder();
+        endResetModel();
+        return;
+    }
+    _world = snapshot;
+    if (_sortcolumn >= ColProduction && _sincesort.elapsed() >= resortinterval){
+        sort(_sortcolumn, _sortorder);
+    }
+    if (_rows > 0) emit dataChanged(index(0, 0), index(_rows - 1, ColCount - 1));
+}
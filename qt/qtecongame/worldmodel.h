@@ -0,0 +1,80 @@
+#ifndef WORLDMODEL_H
+#define WORLDMODEL_H
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <vector>
+#include <cstdint>
+#include "worldsnapshot.h"
+
+// Modelos de tabela sobre o snapshot publicado pela simulacao. Nada e
+// copiado para itens do Qt: data() monta o QVariant so das celulas
+// visiveis que a view pede.
+//
+// Ordenar guarda apenas uma permutacao de indices (4 bytes por linha). Sem
+// ordenacao a linha e o proprio indice denso.
+
+class CompanyTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { ColName, ColCash, ColBuildings, ColCount };
+
+    CompanyTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // O snapshot fica valido ate o proximo acquire() do TripleBuffer.
+    void setSnapshot(const WorldSnapshot* snapshot);
+
+private:
+    const WorldSnapshot* _world = nullptr;
+    std::vector<uint32_t> _order; // linha -> indice da company; vazio = identidade
+    std::vector<uint32_t> _previous; // _order antes do ultimo sort()
+    int _rows = 0;
+    int _sortcolumn = -1;
+    Qt::SortOrder _sortorder = Qt::AscendingOrder;
+
+    size_t companyAt(int row) const { return _order.empty() ? (size_t)row : _order[row]; }
+    void reorder();
+};
+
+class BuildingTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { ColID, ColName, ColType, ColX, ColY, ColOwner,
+                  ColProduction, ColStock, ColPrice, ColIncome, ColCount };
+    static const int resortinterval = 500; // ms entre reordenacoes de colunas que mudam a cada turno
+
+    BuildingTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    void setSnapshot(const WorldSnapshot* snapshot);
+
+private:
+    const WorldSnapshot* _world = nullptr;
+    std::vector<uint32_t> _order; // linha -> indice denso; vazio = identidade
+    std::vector<uint32_t> _previous; // _order antes do ultimo sort()
+    int _rows = 0;
+    uint64_t _layout = 0;
+    int _sortcolumn = -1;
+    Qt::SortOrder _sortorder = Qt::AscendingOrder;
+    QElapsedTimer _sincesort;
+
+    size_t denseAt(int row) const { return _order.empty() ? (size_t)row : _order[row]; }
+    void reorder();
+};
+
+#endif // WORLDMODEL_H
@@ -0,0 +1,81 @@
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "intern.hpp"
+#include "money.hpp"
+#include "cow.hpp"
+
+// Copia imutavel do mundo ao fim de um turno, lida pela UI.
+// As colunas de buildings seguem o indice denso do registro no momento da
+// copia. id, nome, tipo e posicao so mudam quando buildings sao criados ou
+// demolidos (versao "layout"); as demais sao copias COW (cow.hpp) das
+// colunas do TurnEngine: publicar so copia ponteiros, e o motor copia um
+// pedaco quando escrever nele enquanto algum snapshot ainda o usa.
+// Nomes sao Symbols do Interner: o texto fica na arena do nucleo.
+struct WorldSnapshot {
+    struct CompanyRow {
+        Symbol name = 0;
+        int64_t cash = 0; // centavos (Money)
+        size_t buildings = 0;
+    };
+
+    uint64_t turn = 0;
+    uint64_t layout = 0; // versao do conjunto de buildings; 0 = vazio
+    std::vector<CompanyRow> companies;
+
+    std::vector<uint64_t> id;
+    std::vector<Symbol> name;
+    std::vector<int32_t> type;
+    std::vector<int32_t> x;
+    std::vector<int32_t> y;
+
+    CowColumn<int32_t> owner;
+    CowColumn<int32_t> production;
+    CowColumn<int32_t> stock;
+    CowColumn<int32_t> price;
+    CowColumn<int32_t> income;
+
+    size_t size() const { return id.size(); }
+};
+
+// Triple buffer sem lock, um escritor e um leitor. O escritor preenche
+// back() e publica; o leitor pega o mais recente com acquire() e le front()
+// a vontade ate o proximo acquire. Nenhum dos dois espera pelo outro.
+// Os buffers sao reaproveitados, entao depois do aquecimento publicar nao
+// aloca (a nao ser que o mundo cresca).
+template <typename T>
+class TripleBuffer
+{
+public:
+    T& back() { return _buffers[_back]; }
+    const T& front() const { return _buffers[_front]; }
+
+    void publish()
+    {
+        uint8_t old = _middle.exchange(_back | fresh, std::memory_order_acq_rel);
+        _back = old & index;
+    }
+
+    // true se havia uma publicacao nova; front() passa a ser ela.
+    bool acquire()
+    {
+        if ((_middle.load(std::memory_order_relaxed) & fresh) == 0) return false;
+        uint8_t old = _middle.exchange(_front, std::memory_order_acq_rel);
+        _front = old & index;
+        return true;
+    }
+
+private:
+    static const uint8_t index = 3;
+    static const uint8_t fresh = 4;
+    T _buffers[3];
+    uint8_t _front = 0;                 // so o leitor mexe
+    std::atomic<uint8_t> _middle{1};    // indice | fresh
+    uint8_t _back = 2;                  // so o escritor mexe
+};
+
+#endif // WORLDSNAPSHOT_H